@@ -0,0 +1,156 @@
+#include "BCRL/FunctionIndex.hpp"
+#include "BCRL/ResolutionCache.hpp"
+#include "BCRL/SafePointer.hpp"
+#include "BCRL/SearchConstraints.hpp"
+#include "BCRL/Session.hpp"
+
+#include "MemoryManager/LinuxMemoryManager.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using LocalMemoryManager = MemoryManager::LinuxMemoryManager<true, true, true>;
+
+// Hand-assembled code, the leading int3s resynchronize the sweep with the start of the array
+alignas(16) unsigned char aligned_loop[] = {
+	0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xC3, // ret
+	// 0x10: Function
+	0x31, 0xC0, // xor eax, eax
+	0xB9, 0x0A, 0x00, 0x00, 0x00, // mov ecx, 10
+	0x48, 0x89, 0xC2, // mov rdx, rax
+	0x48, 0x89, 0xD0, // mov rax, rdx
+	0x50, // push rax
+	0xEB, 0x04, // jmp condition
+	// 0x20: Loop head, aligned without padding in front of it
+	0x01, 0xC8, // add eax, ecx
+	0xFF, 0xC9, // dec ecx
+	0x85, 0xC9, // condition: test ecx, ecx
+	0x75, 0xF8, // jne loop
+	0x58, // pop rax
+	0xC3, // ret
+	0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC,
+	// 0x30: Function
+	0x31, 0xC0, // xor eax, eax
+	0xC3, // ret
+};
+
+static void check_function_index(const LocalMemoryManager& memory_manager)
+{
+	const BCRL::FunctionIndex index{ memory_manager, BCRL::everything(memory_manager).with_flags("rw-").with_name("BCRLChecks") };
+	const auto base = reinterpret_cast<std::uintptr_t>(aligned_loop);
+
+	assert(index.containing_function(base + 0x24) == base + 0x10); // The loop belongs to the first function
+	assert(index.containing_function(base + 0x31) == base + 0x30);
+	std::println("FunctionIndex: OK");
+}
+
+static void check_resolution_cache(const LocalMemoryManager& memory_manager)
+{
+	BCRL::ResolutionCache cache{ memory_manager, 2 }; // Most keys end up in the overflow map
+	std::atomic<int> computations{ 0 };
+
+	std::vector<std::jthread> threads;
+	for (int thread = 0; thread < 4; thread++)
+		threads.emplace_back([&] {
+			for (int i = 0; i < 8; i++) {
+				const BCRL::Session session = cache.resolve(std::to_string(i), [&](const LocalMemoryManager& m) {
+					computations++;
+					return BCRL::pointer(m, reinterpret_cast<std::uintptr_t>(aligned_loop) + i);
+				});
+				assert(session.peek().size() == 1 && session.peek().front().get_pointer() == reinterpret_cast<std::uintptr_t>(aligned_loop) + i);
+			}
+		});
+	threads.clear();
+	assert(computations == 8); // Every key once, including those which didn't fit into the table
+
+	// Failed computations are retried
+	for (const std::string key : { "0", "failing" }) {
+		bool failed = false;
+		try {
+			(void)cache.resolve(key + "!", [](const LocalMemoryManager&) -> BCRL::Session<LocalMemoryManager> { throw std::runtime_error{ "Failure" }; });
+		} catch (const std::runtime_error&) {
+			failed = true;
+		}
+		assert(failed);
+		const BCRL::Session session = cache.resolve(key + "!", [](const LocalMemoryManager& m) { return BCRL::pointer(m, reinterpret_cast<std::uintptr_t>(aligned_loop)); });
+		assert(session.peek().size() == 1);
+	}
+	std::println("ResolutionCache: OK");
+}
+
+static void check_set_operations(const LocalMemoryManager& memory_manager)
+{
+	const auto base = reinterpret_cast<std::uintptr_t>(aligned_loop);
+	auto session = [&](std::initializer_list<std::uintptr_t> offsets) {
+		std::vector<std::uintptr_t> addresses;
+		for (const std::uintptr_t offset : offsets)
+			addresses.push_back(base + offset);
+		return BCRL::pointer_list(memory_manager, addresses);
+	};
+	auto offsets = [&](const BCRL::Session<LocalMemoryManager>& result) {
+		std::vector<std::uintptr_t> offsets;
+		for (const auto& safe_pointer : result.peek())
+			offsets.push_back(safe_pointer.get_pointer() - base);
+		return offsets;
+	};
+
+	// Odd addresses have no key, the others are keyed by their 16-byte block
+	auto key = [base](const BCRL::SafePointer<LocalMemoryManager>& safe_pointer) -> std::optional<std::uintptr_t> {
+		if (safe_pointer.get_pointer() % 2 != 0)
+			return std::nullopt;
+		return (safe_pointer.get_pointer() - base) / 16;
+	};
+
+	const auto a = session({ 0x00, 0x01, 0x10, 0x11 });
+	const auto b = session({ 0x12, 0x21 });
+
+	assert(offsets(a.clone().intersect(b, key)) == (std::vector<std::uintptr_t>{ 0x10 }));
+	assert(offsets(a.clone().subtract(b, key)) == (std::vector<std::uintptr_t>{ 0x00, 0x01, 0x11 }));
+	assert(offsets(a.clone().unite(b, key)) == (std::vector<std::uintptr_t>{ 0x00, 0x01, 0x10, 0x11, 0x21 }));
+	std::println("Set operations: OK");
+}
+
+static void check_array_reads(const LocalMemoryManager& memory_manager)
+{
+	const BCRL::SafePointer safe_pointer{ memory_manager, reinterpret_cast<std::uintptr_t>(aligned_loop) };
+
+	const auto values = safe_pointer.read_array<std::uint32_t>(2);
+	assert(values.has_value() && values->size() == 2);
+	assert(safe_pointer.view_array<std::uint32_t>(2).has_value());
+
+	// The size in bytes overflows, or the range wraps around the address space
+	for (const std::size_t count : { std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max() / sizeof(std::uint32_t) + 1, std::numeric_limits<std::size_t>::max() / sizeof(std::uint32_t) }) {
+		assert(!safe_pointer.read_array<std::uint32_t>(count).has_value());
+		assert(!safe_pointer.view_array<std::uint32_t>(count).has_value());
+	}
+
+	// The array doesn't fit behind the pointer or its size overflows, the pointer is dropped instead of allocating for it
+	for (const std::size_t count : { std::numeric_limits<std::size_t>::max(), std::numeric_limits<std::size_t>::max() / 8, std::size_t{ 1 } << 40 }) {
+		assert(BCRL::pointer(memory_manager, safe_pointer.get_pointer()).expand_array<std::uint32_t>(count).peek().empty());
+		assert(BCRL::pointer(memory_manager, safe_pointer.get_pointer()).expand_array<std::uint32_t>(count, 8).peek().empty());
+	}
+	assert(BCRL::pointer(memory_manager, safe_pointer.get_pointer()).expand_array<std::uint32_t>(std::numeric_limits<std::size_t>::max(), 0).peek().empty());
+	const std::uintptr_t slots[] = { safe_pointer.get_pointer(), safe_pointer.get_pointer() + 0x10 };
+	assert(BCRL::pointer(memory_manager, reinterpret_cast<std::uintptr_t>(slots)).expand_array(2).peek().size() == 2);
+	std::println("Array reads: OK");
+}
+
+int main()
+{
+	LocalMemoryManager memory_manager;
+	memory_manager.sync_layout();
+
+	check_function_index(memory_manager);
+	check_resolution_cache(memory_manager);
+	check_set_operations(memory_manager);
+	check_array_reads(memory_manager);
+}
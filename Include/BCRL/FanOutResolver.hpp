@@ -0,0 +1,158 @@
+#ifndef BCRL_FANOUTRESOLVER_HPP
+#define BCRL_FANOUTRESOLVER_HPP
+
+#include "detail/Modules.hpp"
+
+#include "Recipe.hpp"
+#include "SafePointer.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Resolves recipes in many processes which run the same binaries.
+	 *
+	 * Modules are identified by their build-id (or a hash of their headers), so a result only has to be searched for once per distinct module.
+	 * Every other process receives it rebased to its own load address, after a comparison of the bytes at the result.
+	 * Processes in which the bytes differ, or which lack one of the modules, are resolved from scratch.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::LengthAware<typename MemMgr::RegionT> && MemoryManager::NameAware<typename MemMgr::RegionT>
+	class FanOutResolver {
+		static constexpr std::size_t CHECK_LENGTH = 16;
+
+		struct RelativeResult {
+			const detail::Module* module; // In the process of the representative
+			std::uintptr_t offset;
+			std::array<std::byte, CHECK_LENGTH> bytes;
+			std::size_t check_length;
+		};
+
+		// Results of a full resolution, expressed relative to the modules they were found in
+		struct Representative {
+			std::vector<RelativeResult> results;
+		};
+
+		std::vector<const MemMgr*> memory_managers;
+		std::vector<std::vector<detail::Module>> modules; // Per process
+
+		std::optional<Representative> make_representative(std::size_t process, const Session<MemMgr>& session) const
+		{
+			// An empty result can't be confirmed by a byte check, a partial one must not be passed on as if it were complete
+			if (session.peek().empty() || session.is_budget_exceeded())
+				return std::nullopt;
+
+			Representative representative;
+			for (const auto& safe_pointer : session.peek()) {
+				const std::uintptr_t address = safe_pointer.get_pointer();
+				const detail::Module* module = detail::find_module(modules[process], address);
+				if (!module)
+					return std::nullopt; // Results in anonymous memory move independently of any module
+
+				RelativeResult result{ module, address - module->base, {}, CHECK_LENGTH };
+				while (result.check_length > 0 && !safe_pointer.is_valid(result.check_length))
+					result.check_length /= 2;
+				if (result.check_length == 0)
+					return std::nullopt;
+				memory_managers[process]->read(address, result.bytes.data(), result.check_length);
+
+				representative.results.push_back(result);
+			}
+			return representative;
+		}
+
+		std::optional<std::vector<std::uintptr_t>> rebase(const Representative& representative, std::size_t process) const
+		{
+			std::vector<std::uintptr_t> addresses;
+			addresses.reserve(representative.results.size());
+
+			for (const RelativeResult& result : representative.results) {
+				auto module = std::ranges::find_if(modules[process], [&result](const detail::Module& m) {
+					return m.identity == result.module->identity && m.name == result.module->name;
+				});
+				if (module == modules[process].end())
+					return std::nullopt;
+
+				const std::uintptr_t address = module->base + result.offset;
+				std::array<std::byte, CHECK_LENGTH> bytes{};
+				if (!SafePointer{ *memory_managers[process], address }.read(bytes.data(), result.check_length)
+					|| !std::ranges::equal(std::span{ bytes }.first(result.check_length), std::span{ result.bytes }.first(result.check_length)))
+					return std::nullopt;
+
+				addresses.push_back(address);
+			}
+
+			return addresses;
+		}
+
+	public:
+		// Returns the index of the process in the results
+		std::size_t add(const MemMgr& memory_manager)
+		{
+			memory_managers.push_back(&memory_manager);
+			modules.push_back(detail::list_modules(memory_manager));
+			return memory_managers.size() - 1;
+		}
+
+		// Rereads the module lists, call this after the layouts of the processes changed
+		void refresh()
+		{
+			for (std::size_t i = 0; i < memory_managers.size(); i++)
+				modules[i] = detail::list_modules(*memory_managers[i]);
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return memory_managers.size();
+		}
+
+		// Returns one session per process, in the order the processes were added
+		template <typename F>
+			requires std::is_invocable_r_v<Session<MemMgr>, F, const MemMgr&>
+		[[nodiscard]] std::vector<Session<MemMgr>> resolve(const F& computation) const
+		{
+			std::vector<Session<MemMgr>> sessions;
+			sessions.reserve(memory_managers.size());
+
+			std::vector<Representative> representatives;
+
+			for (std::size_t process = 0; process < memory_managers.size(); process++) {
+				std::optional<std::vector<std::uintptr_t>> rebased;
+				for (const Representative& representative : representatives)
+					if ((rebased = rebase(representative, process)))
+						break;
+
+				if (rebased) {
+					sessions.push_back(pointer_list(*memory_managers[process], *rebased));
+					continue;
+				}
+
+				Session<MemMgr> session = computation(*memory_managers[process]);
+				if (auto representative = make_representative(process, session))
+					representatives.emplace_back(std::move(*representative));
+				sessions.emplace_back(std::move(session));
+			}
+
+			return sessions;
+		}
+
+		[[nodiscard]] std::vector<Session<MemMgr>> resolve(const Recipe<MemMgr>& recipe) const
+		{
+			return resolve([&recipe](const MemMgr& memory_manager) {
+				return recipe.resolve(memory_manager);
+			});
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef BCRL_FIXEDSIGNATURE_HPP
+#define BCRL_FIXEDSIGNATURE_HPP
+
+#include "detail/ByteFrequency.hpp"
+#include "detail/PatternText.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	namespace detail {
+		template <std::size_t N>
+		struct FixedString {
+			std::array<char, N> data{};
+
+			constexpr FixedString(const char (&string)[N]) // NOLINT(google-explicit-constructor, hicpp-explicit-conversions)
+			{
+				std::copy_n(string, N, data.begin());
+			}
+
+			[[nodiscard]] constexpr std::size_t length() const
+			{
+				return N - 1; // Null terminator
+			}
+		};
+
+		struct FixedElement {
+			std::byte value;
+			bool wildcard;
+		};
+
+		constexpr std::uint8_t parse_hex_digit(char c)
+		{
+			if (c >= '0' && c <= '9')
+				return c - '0';
+			if (c >= 'a' && c <= 'f')
+				return c - 'a' + 10;
+			if (c >= 'A' && c <= 'F')
+				return c - 'A' + 10;
+			throw "Invalid hex digit in signature"; // Fails constant evaluation
+		}
+
+		template <FixedString String>
+		constexpr std::size_t count_array_of_bytes_elements()
+		{
+			std::size_t count = 0;
+			bool in_token = false;
+			for (std::size_t i = 0; i < String.length(); i++) {
+				const bool separator = String.data[i] == ' ';
+				if (!separator && !in_token)
+					count++;
+				in_token = !separator;
+			}
+			return count;
+		}
+
+		template <FixedString String>
+		constexpr auto parse_array_of_bytes()
+		{
+			std::array<FixedElement, count_array_of_bytes_elements<String>()> elements{};
+			std::size_t element = 0;
+			for (std::size_t i = 0; i < String.length();) {
+				if (String.data[i] == ' ') {
+					i++;
+					continue;
+				}
+				if (String.data[i] == '?') {
+					elements[element++] = { std::byte{ 0 }, true };
+					while (i < String.length() && String.data[i] == '?')
+						i++;
+					continue;
+				}
+				if (i + 1 >= String.length() || String.data[i + 1] == ' ')
+					throw "Bytes in signatures need two hex digits";
+				elements[element++] = { static_cast<std::byte>(parse_hex_digit(String.data[i]) << 4 | parse_hex_digit(String.data[i + 1])), false };
+				i += 2;
+			}
+			return elements;
+		}
+	}
+
+	/**
+	 * A pattern signature which is known at compile time.
+	 * Matching is unrolled into compares of the non-wildcard bytes and searches look for the rarest byte of the pattern first.
+	 */
+	template <auto Elements>
+	class FixedPatternSignature {
+	public:
+		static constexpr std::size_t SIZE = Elements.size();
+
+		// Position of the byte which the search looks for before testing the whole pattern
+		static constexpr std::size_t ANCHOR = [] {
+			std::size_t anchor = SIZE;
+			for (std::size_t i = 0; i < SIZE; i++)
+				if (!Elements[i].wildcard && (anchor == SIZE || detail::byte_commonness(Elements[i].value) < detail::byte_commonness(Elements[anchor].value)))
+					anchor = i;
+			return anchor;
+		}();
+
+		static constexpr bool HAS_ANCHOR = ANCHOR != SIZE;
+
+		// `bytes` has to point to at least SIZE bytes
+		[[nodiscard]] static constexpr bool matches(const std::byte* bytes)
+		{
+			return [bytes]<std::size_t... I>(std::index_sequence<I...>) {
+				return ((Elements[I].wildcard || bytes[I] == Elements[I].value) && ...);
+			}(std::make_index_sequence<SIZE>{});
+		}
+
+		// Offset of the first match in `haystack` starting at `from`, or haystack.size()
+		[[nodiscard]] static std::size_t next(std::span<const std::byte> haystack, std::size_t from = 0)
+		{
+			if (haystack.size() < SIZE)
+				return haystack.size();
+
+			const std::size_t last_start = haystack.size() - SIZE;
+
+			if constexpr (!HAS_ANCHOR) {
+				return from <= last_start ? from : haystack.size();
+			} else {
+				std::size_t start = from;
+				while (start <= last_start) {
+					const void* anchor = std::memchr(haystack.data() + start + ANCHOR, static_cast<int>(Elements[ANCHOR].value), last_start - start + 1);
+					if (anchor == nullptr)
+						break;
+
+					start = static_cast<const std::byte*>(anchor) - haystack.data() - ANCHOR;
+					if (matches(haystack.data() + start))
+						return start;
+					start++;
+				}
+				return haystack.size();
+			}
+		}
+
+		[[nodiscard]] static SignatureScanner::PatternSignature to_pattern_signature()
+		{
+			std::vector<detail::PatternElement> elements;
+			elements.reserve(SIZE);
+			for (const detail::FixedElement& element : Elements) {
+				if (element.wildcard)
+					elements.emplace_back();
+				else
+					elements.emplace_back(element.value);
+			}
+			return SignatureScanner::PatternSignature{ std::move(elements) };
+		}
+	};
+
+	namespace detail {
+		template <typename T>
+		struct IsFixedPatternSignature : std::false_type { };
+
+		template <auto Elements>
+		struct IsFixedPatternSignature<FixedPatternSignature<Elements>> : std::true_type { };
+	}
+
+	template <typename T>
+	concept FixedSignature = detail::IsFixedPatternSignature<std::remove_cvref_t<T>>::value;
+
+	// Compile-time counterpart to `PatternSignature::for_array_of_bytes`, e.g. fixed_array_of_bytes<"e8 ? ? ? ?">()
+	template <detail::FixedString String>
+	[[nodiscard]] constexpr auto fixed_array_of_bytes()
+	{
+		return FixedPatternSignature<detail::parse_array_of_bytes<String>()>{};
+	}
+
+	// Compile-time counterpart to `PatternSignature::for_literal_string`
+	template <detail::FixedString String, bool IncludeNullTerminator = true>
+	[[nodiscard]] constexpr auto fixed_literal_string()
+	{
+		constexpr auto ELEMENTS = [] {
+			std::array<detail::FixedElement, IncludeNullTerminator ? String.length() + 1 : String.length()> elements{};
+			for (std::size_t i = 0; i < elements.size(); i++)
+				elements[i] = { static_cast<std::byte>(String.data[i]), false };
+			return elements;
+		}();
+		return FixedPatternSignature<ELEMENTS>{};
+	}
+}
+
+#endif
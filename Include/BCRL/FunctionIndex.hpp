@@ -0,0 +1,225 @@
+#ifndef BCRL_FUNCTIONINDEX_HPP
+#define BCRL_FUNCTIONINDEX_HPP
+
+#include "detail/RegionBytes.hpp"
+#include "detail/X86.hpp"
+
+#include "SearchConstraints.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "LengthDisassembler/LengthDisassembler.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Function boundaries and call graph of a set of executable regions, recovered by a linear sweep.
+	 *
+	 * Functions are assumed to start at
+	 * 	- targets of relative calls
+	 * 	- endbr instructions
+	 * 	- the first 16-byte aligned instruction after a ret, or after a jmp which is followed by padding
+	 * The last one only applies to regions without endbr instructions. Compilers align loop heads as well,
+	 * so it is a fallback for code which wasn't built with CET, where functions that are only reached through jumps would be missed otherwise.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT>
+	class FunctionIndex {
+	public:
+		struct Call {
+			std::uintptr_t caller; // Start of the calling function
+			std::uintptr_t callee;
+		};
+
+	private:
+		static constexpr std::size_t FUNCTION_ALIGNMENT = 16;
+
+		// How the preceding instructions ended
+		enum class Boundary : std::uint8_t {
+			NONE,
+			JUMP, // A jmp, which only ends the function if padding follows, otherwise the next instruction may be a loop head
+			END, // A ret, or a jmp and its padding
+		};
+
+		std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ranges; // [begin, end) of every swept region
+		std::vector<std::uintptr_t> function_starts;
+		std::vector<Call> calls_by_caller;
+		std::vector<Call> calls_by_callee;
+
+		[[nodiscard]] bool is_indexed(std::uintptr_t address) const
+		{
+			auto it = std::ranges::upper_bound(ranges, address, {}, &std::pair<std::uintptr_t, std::uintptr_t>::first);
+			return it != ranges.begin() && address < std::prev(it)->second;
+		}
+
+		static bool is_padding(std::span<const std::byte> instruction, std::size_t prefixes)
+		{
+			const auto opcode = static_cast<std::uint8_t>(instruction[prefixes]);
+			if (opcode == 0xCC || opcode == 0x90)
+				return true;
+			// Multi-byte nop (0f 1f /0)
+			return opcode == 0x0F && prefixes + 1 < instruction.size() && instruction[prefixes + 1] == std::byte{ 0x1F };
+		}
+
+	public:
+		explicit FunctionIndex(
+			const MemMgr& memory_manager,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().with_flags("r-x"),
+			LengthDisassembler::MachineMode mode = (sizeof(void*) == 8)
+				? LengthDisassembler::MachineMode::LONG_MODE
+				: LengthDisassembler::MachineMode::LONG_COMPATIBILITY_MODE)
+		{
+			const bool long_mode = mode == LengthDisassembler::MachineMode::LONG_MODE;
+			std::vector<std::pair<std::uintptr_t, std::uintptr_t>> call_sites; // (call instruction, callee)
+
+			for (const auto& region : memory_manager.get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+
+				detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ region };
+				std::span<const std::byte> bytes = region_bytes.get();
+				const std::uintptr_t base = region.get_address();
+
+				ranges.emplace_back(base, base + bytes.size());
+
+				Boundary boundary = Boundary::END; // The region start counts as a potential function start
+				bool has_endbr = false;
+				std::vector<std::uintptr_t> aligned_starts;
+				std::size_t offset = 0;
+				while (offset < bytes.size()) {
+					std::span<const std::byte> instruction = bytes.subspan(offset, std::min(bytes.size() - offset, LengthDisassembler::MAX_INSTRUCTION_LENGTH));
+
+					auto decoded = LengthDisassembler::disassemble(instruction.data(), mode, instruction.size());
+					if (!decoded.has_value()) {
+						// Data or misaligned code, resynchronize on the next byte
+						offset++;
+						continue;
+					}
+					instruction = instruction.first(decoded.value().length);
+
+					const std::size_t prefixes = detail::x86::prefix_length(instruction, long_mode);
+					const std::uintptr_t address = base + offset;
+
+					if (prefixes < instruction.size()) {
+						if (is_padding(instruction, prefixes)) {
+							if (boundary == Boundary::JUMP)
+								boundary = Boundary::END;
+						} else {
+							if (boundary == Boundary::END && address % FUNCTION_ALIGNMENT == 0)
+								aligned_starts.push_back(address);
+							boundary = Boundary::NONE;
+						}
+
+						if (detail::x86::is_endbr(instruction)) {
+							function_starts.push_back(address);
+							has_endbr = true;
+						}
+
+						const auto opcode = static_cast<std::uint8_t>(instruction[prefixes]);
+						switch (opcode) {
+						case 0xE8: // call rel32
+							if (instruction.size() == prefixes + 5)
+								call_sites.emplace_back(address, address + instruction.size() + detail::x86::read_rel32(instruction.subspan(prefixes + 1)));
+							break;
+						case 0xC3: // ret
+						case 0xC2: // ret imm16
+							boundary = Boundary::END;
+							break;
+						case 0xE9: // jmp rel32
+						case 0xEB: // jmp rel8
+							boundary = Boundary::JUMP;
+							break;
+						default:
+							break;
+						}
+					}
+
+					offset += instruction.size();
+				}
+
+				if (!has_endbr)
+					function_starts.insert(function_starts.end(), aligned_starts.begin(), aligned_starts.end());
+			}
+
+			std::ranges::sort(ranges);
+
+			for (const auto& [site, callee] : call_sites)
+				if (is_indexed(callee))
+					function_starts.push_back(callee);
+
+			std::ranges::sort(function_starts);
+			auto [first, last] = std::ranges::unique(function_starts);
+			function_starts.erase(first, last);
+
+			calls_by_caller.reserve(call_sites.size());
+			for (const auto& [site, callee] : call_sites) {
+				std::optional<std::uintptr_t> caller = containing_function(site);
+				if (caller.has_value())
+					calls_by_caller.push_back({ caller.value(), callee });
+			}
+
+			auto deduplicate = [](std::vector<Call>& calls, auto key, auto other) {
+				std::ranges::sort(calls, [&](const Call& a, const Call& b) {
+					return std::pair{ a.*key, a.*other } < std::pair{ b.*key, b.*other };
+				});
+				auto [first, last] = std::ranges::unique(calls, [](const Call& a, const Call& b) {
+					return a.caller == b.caller && a.callee == b.callee;
+				});
+				calls.erase(first, last);
+				calls.shrink_to_fit();
+			};
+
+			calls_by_callee = calls_by_caller;
+			deduplicate(calls_by_caller, &Call::caller, &Call::callee);
+			deduplicate(calls_by_callee, &Call::callee, &Call::caller);
+		}
+
+		// Start of the function which contains the address
+		[[nodiscard]] std::optional<std::uintptr_t> containing_function(std::uintptr_t address) const
+		{
+			if (!is_indexed(address))
+				return std::nullopt;
+
+			auto it = std::ranges::upper_bound(function_starts, address);
+			if (it == function_starts.begin())
+				return std::nullopt;
+
+			std::uintptr_t start = *std::prev(it);
+
+			// Functions don't cross region boundaries
+			auto range = std::ranges::upper_bound(ranges, address, {}, &std::pair<std::uintptr_t, std::uintptr_t>::first);
+			if (start < std::prev(range)->first)
+				return std::nullopt;
+
+			return start;
+		}
+
+		// Calls made by the function starting at `function`
+		[[nodiscard]] std::span<const Call> callees_of(std::uintptr_t function) const
+		{
+			auto [first, last] = std::ranges::equal_range(calls_by_caller, function, {}, &Call::caller);
+			return { first, last };
+		}
+
+		// Calls which target `function`
+		[[nodiscard]] std::span<const Call> callers_of(std::uintptr_t function) const
+		{
+			auto [first, last] = std::ranges::equal_range(calls_by_callee, function, {}, &Call::callee);
+			return { first, last };
+		}
+
+		[[nodiscard]] std::span<const std::uintptr_t> get_function_starts() const
+		{
+			return function_starts;
+		}
+	};
+}
+
+#endif
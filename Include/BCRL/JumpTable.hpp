@@ -0,0 +1,260 @@
+#ifndef BCRL_JUMPTABLE_HPP
+#define BCRL_JUMPTABLE_HPP
+
+#include "detail/Modules.hpp"
+#include "detail/X86.hpp"
+
+#include "SafePointer.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "LengthDisassembler/LengthDisassembler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	// The dispatch of a `switch` statement through a table of case targets
+	struct JumpTable {
+		enum class Kind : std::uint8_t {
+			RELATIVE, // 32-bit offsets from the start of the table, emitted for position independent code
+			ABSOLUTE, // Pointers
+		};
+
+		std::uintptr_t dispatch; // The indirect jump
+		std::uintptr_t table;
+		Kind kind;
+		std::vector<std::uintptr_t> targets; // One per case, in the order of the table
+	};
+
+	/**
+	 * Recovers jump tables from the dispatch code of `switch` statements.
+	 *
+	 * Starting at a pointer, a few instructions are decoded, looking for either
+	 * - lea table(%rip), %base; movslq (%base,%index,4), %entry; add %base, %entry; jmp *%entry
+	 * - jmp *table(,%index,8)
+	 * The number of cases is taken from a preceding bounds check (cmp $n, %index; ja default), otherwise entries are taken
+	 * for as long as they point into executable memory. The table is then read at once.
+	 *
+	 * Tables are cached per module, so repeated queries for the same dispatch code, also after the module was reloaded, don't decode again.
+	 * The memory manager has to outlive this object, call `refresh` after its layout changed.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::LengthAware<typename MemMgr::RegionT> && MemoryManager::NameAware<typename MemMgr::RegionT> && MemoryManager::FlagAware<typename MemMgr::RegionT>
+	class JumpTableCache {
+		static constexpr std::size_t MAX_DISPATCH_INSTRUCTIONS = 16;
+		static constexpr std::size_t MAX_ENTRIES = 4096;
+		static constexpr std::uint8_t NO_REGISTER = 0xFF;
+
+		const MemMgr* memory_manager;
+		LengthDisassembler::MachineMode mode;
+		std::vector<detail::Module> modules;
+		// Module identity to tables, addresses are relative to the module base; Pointers without a table are cached as well
+		std::unordered_map<std::uint64_t, std::unordered_map<std::uintptr_t, std::optional<JumpTable>>> tables;
+
+		static JumpTable rebased(JumpTable table, std::uintptr_t from, std::uintptr_t to)
+		{
+			table.dispatch = table.dispatch - from + to;
+			table.table = table.table - from + to;
+			for (std::uintptr_t& target : table.targets)
+				target = target - from + to;
+			return table;
+		}
+
+		[[nodiscard]] bool is_executable(std::uintptr_t address) const
+		{
+			auto* region = memory_manager->get_layout().find_region(address);
+			return region && region->get_flags().is_executable();
+		}
+
+		[[nodiscard]] std::optional<JumpTable> read_table(std::uintptr_t dispatch, std::uintptr_t table, JumpTable::Kind kind, std::optional<std::size_t> case_count) const
+		{
+			const std::size_t entry_size = kind == JumpTable::Kind::RELATIVE ? sizeof(std::int32_t) : sizeof(std::uintptr_t);
+
+			auto* region = memory_manager->get_layout().find_region(table);
+			if (!region)
+				return std::nullopt;
+			const std::size_t available = (region->get_address() + region->get_length() - table) / entry_size;
+			const std::size_t count = std::min(case_count.value_or(MAX_ENTRIES), available);
+
+			const SafePointer<MemMgr> safe_pointer{ *memory_manager, table };
+			std::vector<std::uintptr_t> targets;
+			if (kind == JumpTable::Kind::RELATIVE) {
+				if (auto entries = safe_pointer.template read_array<std::int32_t>(count))
+					for (const std::int32_t entry : *entries)
+						targets.push_back(table + static_cast<std::uintptr_t>(static_cast<std::intptr_t>(entry)));
+			} else {
+				if (auto entries = safe_pointer.template read_array<std::uintptr_t>(count))
+					targets = std::move(*entries);
+			}
+
+			// Without a bounds check, the table ends where the entries stop looking like code
+			if (!case_count) {
+				auto end = std::ranges::find_if_not(targets, [this](std::uintptr_t target) { return is_executable(target); });
+				targets.erase(end, targets.end());
+			}
+
+			if (targets.empty())
+				return std::nullopt;
+			return JumpTable{ dispatch, table, kind, std::move(targets) };
+		}
+
+		[[nodiscard]] std::optional<JumpTable> analyse(std::uintptr_t address) const
+		{
+			static constexpr std::size_t WINDOW = MAX_DISPATCH_INSTRUCTIONS * 8;
+
+			auto* region = memory_manager->get_layout().find_region(address);
+			if (!region)
+				return std::nullopt;
+
+			std::array<std::byte, WINDOW> bytes{};
+			const std::size_t length = std::min(region->get_address() + region->get_length() - address, WINDOW);
+			if (!SafePointer{ *memory_manager, address }.read(bytes.data(), length))
+				return std::nullopt;
+
+			const bool long_mode = mode == LengthDisassembler::MachineMode::LONG_MODE;
+
+			std::optional<std::size_t> case_count;
+			std::optional<std::int64_t> compared; // Immediate of the previous instruction, if it was a cmp
+			std::uint8_t base_register = NO_REGISTER;
+			std::uintptr_t base = 0;
+			std::uint8_t entry_register = NO_REGISTER; // Holds an entry of a relative table which belongs to `base`
+			std::uint8_t target_register = NO_REGISTER; // Holds the entry plus `base`
+
+			std::size_t offset = 0;
+			for (std::size_t n = 0; n < MAX_DISPATCH_INSTRUCTIONS && offset < length; n++) {
+				std::span<const std::byte> instruction = std::span{ bytes }.subspan(offset, std::min(length - offset, LengthDisassembler::MAX_INSTRUCTION_LENGTH));
+				auto decoded = LengthDisassembler::disassemble(instruction.data(), mode, instruction.size());
+				if (!decoded.has_value())
+					return std::nullopt;
+				instruction = instruction.first(decoded.value().length);
+				offset += instruction.size();
+				const std::uintptr_t next = address + offset;
+
+				const std::size_t prefixes = detail::x86::prefix_length(instruction, long_mode);
+				if (prefixes >= instruction.size())
+					continue;
+
+				auto at = [&instruction, prefixes](std::size_t i) -> std::optional<std::uint8_t> {
+					if (prefixes + i >= instruction.size())
+						return std::nullopt;
+					return static_cast<std::uint8_t>(instruction[prefixes + i]);
+				};
+				const std::uint8_t rex = long_mode && prefixes > 0 && (static_cast<std::uint8_t>(instruction[prefixes - 1]) & 0xF0) == 0x40
+					? static_cast<std::uint8_t>(instruction[prefixes - 1])
+					: 0;
+				const std::uint8_t opcode = *at(0);
+				const std::uint8_t modrm = at(1).value_or(0);
+				const std::uint8_t sib = at(2).value_or(0);
+
+				const std::uint8_t mod = modrm >> 6;
+				const std::uint8_t extension = (modrm >> 3) & 0x7;
+				const auto reg = static_cast<std::uint8_t>(extension | ((rex & 0x4) << 1));
+				const auto rm = static_cast<std::uint8_t>((modrm & 0x7) | ((rex & 0x1) << 3));
+				const std::size_t scale = std::size_t{ 1 } << (sib >> 6);
+				const auto sib_base = static_cast<std::uint8_t>((sib & 0x7) | ((rex & 0x1) << 3));
+				const bool has_sib = mod == 0 && (modrm & 0x7) == 0x4;
+
+				std::optional<std::int64_t> immediate;
+				if ((opcode == 0x83 || opcode == 0x81) && mod == 3 && extension == 7 && instruction.size() >= prefixes + 3) // cmp r/m, imm
+					immediate = opcode == 0x83
+						? static_cast<std::int8_t>(*at(2))
+						: detail::x86::read_rel32(instruction.subspan(prefixes + 2));
+				else if (opcode == 0x3D && instruction.size() >= prefixes + 5) // cmp eax, imm32
+					immediate = detail::x86::read_rel32(instruction.subspan(prefixes + 1));
+
+				// ja/jae to the default case, after comparing the index to the highest/first invalid case
+				const bool is_ja = opcode == 0x77 || (opcode == 0x0F && at(1) == 0x87);
+				const bool is_jae = opcode == 0x73 || (opcode == 0x0F && at(1) == 0x83);
+				if (compared && *compared >= 0 && (is_ja || is_jae)) {
+					const auto count = static_cast<std::size_t>(*compared) + (is_ja ? 1 : 0);
+					if (count <= MAX_ENTRIES)
+						case_count = count;
+				}
+				compared = immediate;
+
+				if (long_mode && opcode == 0x8D && mod == 0 && (modrm & 0x7) == 0x5 && instruction.size() >= prefixes + 6) { // lea reg, [rip + disp32]
+					base_register = reg;
+					base = next + static_cast<std::uintptr_t>(static_cast<std::intptr_t>(detail::x86::read_rel32(instruction.subspan(prefixes + 2))));
+					if (entry_register == reg)
+						entry_register = NO_REGISTER;
+				} else if (opcode == 0x63 && (rex & 0x8) && has_sib && scale == 4 && base_register == sib_base) { // movsxd reg, [base + index * 4]
+					entry_register = reg;
+				} else if ((opcode == 0x01 || opcode == 0x03) && mod == 3) { // add
+					const std::uint8_t destination = opcode == 0x01 ? rm : reg;
+					const std::uint8_t source = opcode == 0x01 ? reg : rm;
+					if ((destination == entry_register && source == base_register) || (destination == base_register && source == entry_register))
+						target_register = destination;
+				} else if (opcode == 0xFF && extension == 4) { // jmp r/m
+					if (mod == 3) {
+						if (rm == target_register)
+							return read_table(next - instruction.size(), base, JumpTable::Kind::RELATIVE, case_count);
+						return std::nullopt;
+					}
+					if (has_sib && scale == sizeof(std::uintptr_t)) {
+						if ((sib & 0x7) == 0x5 && instruction.size() >= prefixes + 7) // No base, just disp32
+							return read_table(next - instruction.size(), static_cast<std::uintptr_t>(static_cast<std::intptr_t>(detail::x86::read_rel32(instruction.subspan(prefixes + 3)))), JumpTable::Kind::ABSOLUTE, case_count);
+						if (base_register == sib_base)
+							return read_table(next - instruction.size(), base, JumpTable::Kind::ABSOLUTE, case_count);
+					}
+					return std::nullopt;
+				} else if (opcode == 0xC3 || opcode == 0xC2 || opcode == 0xE9 || opcode == 0xEB) {
+					return std::nullopt; // The dispatch code ended without an indirect jump
+				}
+			}
+
+			return std::nullopt;
+		}
+
+	public:
+		explicit JumpTableCache(
+			const MemMgr& memory_manager,
+			LengthDisassembler::MachineMode mode = (sizeof(void*) == 8)
+				? LengthDisassembler::MachineMode::LONG_MODE
+				: LengthDisassembler::MachineMode::LONG_COMPATIBILITY_MODE)
+			: memory_manager(&memory_manager)
+			, mode(mode)
+			, modules(detail::list_modules(memory_manager))
+		{
+		}
+
+		// Rereads the module list, analysed tables are kept for modules which are still loaded or get loaded again
+		void refresh()
+		{
+			modules = detail::list_modules(*memory_manager);
+		}
+
+		// The jump table dispatched by the code at `address`
+		[[nodiscard]] std::optional<JumpTable> find(std::uintptr_t address)
+		{
+			const detail::Module* module = detail::find_module(modules, address);
+			if (!module)
+				return analyse(address); // Code outside of modules, e.g. generated at runtime, may change at any time
+
+			auto& module_tables = tables[module->identity];
+			auto [it, inserted] = module_tables.try_emplace(address - module->base);
+			if (inserted)
+				if (std::optional<JumpTable> table = analyse(address))
+					it->second = rebased(std::move(*table), module->base, 0);
+
+			if (!it->second)
+				return std::nullopt;
+			return rebased(*it->second, 0, module->base);
+		}
+
+		[[nodiscard]] constexpr const MemMgr& get_memory_manager() const
+		{
+			return *memory_manager;
+		}
+	};
+}
+
+#endif
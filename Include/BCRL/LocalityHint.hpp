@@ -0,0 +1,178 @@
+#ifndef BCRL_LOCALITYHINT_HPP
+#define BCRL_LOCALITYHINT_HPP
+
+#include "detail/Modules.hpp"
+
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Where a signature was found in a previous build of the module.
+	 * The search starts in a window of `initial_window` bytes around it and doubles the window until `max_window`.
+	 */
+	struct LocalityHint {
+		std::string module; // Region name, e.g. "libfoo.so"
+		std::uintptr_t offset; // Relative to the lowest address of the module
+		std::size_t initial_window = 0x1000;
+		std::size_t max_window = 0x100000;
+	};
+
+	// Creates the hint for an address that was resolved in the current build
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::NameAware<typename MemMgr::RegionT>
+	[[nodiscard]] std::optional<LocalityHint> make_locality_hint(const MemMgr& memory_manager, std::uintptr_t address)
+	{
+		auto* region = memory_manager.get_layout().find_region(address);
+		if (!region)
+			return std::nullopt;
+
+		std::string name{ region->get_name() };
+		std::optional<std::uintptr_t> base = detail::module_base(memory_manager, name);
+		if (!base)
+			return std::nullopt;
+
+		return LocalityHint{ std::move(name), address - *base };
+	}
+
+	/**
+	 * Result of a hinted signature scan.
+	 *
+	 * If the smallest window around the hint which contains any match contains exactly one, that match is available immediately,
+	 * while the rest of the search space is scanned on a background thread to confirm that it is unique.
+	 * Otherwise, the full scan already happened and there is nothing left to confirm.
+	 *
+	 * The background scan reads the layout of the memory manager while the caller continues, so the layout must not change
+	 * (e.g. through `sync_layout()`) until `is_unique` or `get_confirmed_session` returned, or this object was destroyed.
+	 * Every scan which used a window starts its own thread for this.
+	 * The memory manager has to outlive this object, the destructor waits for the background scan.
+	 */
+	template <typename MemMgr>
+	class HintedScan {
+		Session<MemMgr> session;
+		std::future<std::vector<std::uintptr_t>> others; // Matches outside of the window, valid until `confirm` was called
+		std::optional<bool> unique;
+
+		void confirm()
+		{
+			if (!others.valid())
+				return;
+
+			std::vector<std::uintptr_t> other_matches = others.get();
+			unique = other_matches.empty();
+			if (!other_matches.empty()) {
+				Session<MemMgr> all{ session.get_memory_manager(), other_matches };
+				session.unite(all);
+			}
+		}
+
+	public:
+		HintedScan(Session<MemMgr>&& session, std::future<std::vector<std::uintptr_t>>&& others)
+			: session(std::move(session))
+			, others(std::move(others))
+		{
+		}
+
+		// Whether the result came from a window around the hint
+		[[nodiscard]] bool used_hint() const
+		{
+			return others.valid() || unique.has_value();
+		}
+
+		// The result of the window, or of the full scan if the hint didn't help
+		[[nodiscard]] Session<MemMgr> get_session() const
+		{
+			return session.clone();
+		}
+
+		// Waits for the background scan, returns whether the result of the window was the only match
+		[[nodiscard]] bool is_unique()
+		{
+			confirm();
+			return unique.value_or(session.peek().size() == 1);
+		}
+
+		// Waits for the background scan, returns all matches, like a full scan would
+		[[nodiscard]] Session<MemMgr> get_confirmed_session()
+		{
+			confirm();
+			return session.clone();
+		}
+	};
+
+	/**
+	 * Signature scan which starts around a hint from a previous build, see HintedScan.
+	 * Falls back to a full scan if the hinted module is gone, no window contains a match, or a window contains multiple.
+	 * If a window contains a single match, the rest is scanned on a thread of its own, during which the layout must not change.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::Viewable<typename MemMgr::RegionT> && MemoryManager::NameAware<typename MemMgr::RegionT>
+	[[nodiscard]] HintedScan<MemMgr> signature_near(
+		const MemMgr& memory_manager,
+		const SignatureScanner::PatternSignature& signature,
+		const LocalityHint& hint,
+		const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+	{
+		using Constraints = SearchConstraints<typename MemMgr::RegionT>;
+
+		// Restricts the constraints to [begin, end), while keeping their own address range
+		auto restricted = [&search_constraints](std::uintptr_t begin, std::uintptr_t end) {
+			search_constraints.clamp_to_address_range(begin, end);
+			return Constraints{ search_constraints }.from(begin).to(end);
+		};
+
+		const std::optional<std::uintptr_t> base = detail::module_base(memory_manager, hint.module);
+		if (base) {
+			const std::uintptr_t center = *base + hint.offset;
+			// Matches which cross the border of the window belong to the rest of the search space as well
+			const std::size_t overlap = signature.get_elements().empty() ? 0 : signature.get_elements().size() - 1;
+
+			for (std::size_t window = std::max<std::size_t>(hint.initial_window, 1);; window *= 2) {
+				window = std::min(window, hint.max_window);
+				const std::uintptr_t begin = center > window / 2 ? center - window / 2 : 0;
+				const std::uintptr_t end = std::numeric_limits<std::uintptr_t>::max() - center > window / 2 ? center + window / 2 : std::numeric_limits<std::uintptr_t>::max();
+
+				Session<MemMgr> session = BCRL::signature(memory_manager, signature, restricted(begin, end));
+				if (session.peek().size() > 1)
+					break; // Ambiguous, only a full scan can tell which match is wanted
+				if (session.peek().size() == 1) {
+					const std::uintptr_t match = session.peek().front().get_pointer();
+
+					auto others = std::async(std::launch::async, [&memory_manager, signature, before = restricted(0, begin + overlap), after = restricted(end > overlap ? end - overlap : 0, std::numeric_limits<std::uintptr_t>::max()), match] {
+						std::vector<std::uintptr_t> matches;
+						for (const Constraints& constraints : { before, after }) {
+							const Session<MemMgr> rest = BCRL::signature(memory_manager, signature, constraints);
+							for (const auto& safe_pointer : rest.peek())
+								if (safe_pointer.get_pointer() != match)
+									matches.push_back(safe_pointer.get_pointer());
+						}
+						return matches;
+					});
+
+					return { std::move(session), std::move(others) };
+				}
+
+				if (window >= hint.max_window)
+					break;
+			}
+		}
+
+		return { BCRL::signature(memory_manager, signature, search_constraints), {} };
+	}
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef BCRL_PAGEFINGERPRINT_HPP
+#define BCRL_PAGEFINGERPRINT_HPP
+
+#include "detail/LambdaInserter.hpp"
+#include "detail/RegionBytes.hpp"
+
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	namespace detail {
+		// XXH64-style hash, four independent lanes keep the multipliers busy
+		inline std::uint64_t hash_page(std::span<const std::byte> bytes)
+		{
+			static constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87;
+			static constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4F;
+			static constexpr std::uint64_t PRIME_3 = 0x165667B19E3779F9;
+
+			auto round = [](std::uint64_t accumulator, std::uint64_t word) {
+				return std::rotl(accumulator + word * PRIME_2, 31) * PRIME_1;
+			};
+
+			std::array<std::uint64_t, 4> lanes{ PRIME_1 + PRIME_2, PRIME_2, 0, -PRIME_1 };
+
+			std::size_t offset = 0;
+			for (; offset + sizeof(lanes) <= bytes.size(); offset += sizeof(lanes)) {
+				std::array<std::uint64_t, 4> words; // NOLINT(cppcoreguidelines-pro-type-member-init)
+				std::memcpy(words.data(), bytes.data() + offset, sizeof(words));
+				for (std::size_t i = 0; i < lanes.size(); i++)
+					lanes[i] = round(lanes[i], words[i]);
+			}
+
+			std::uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+			for (; offset < bytes.size(); offset++)
+				hash = std::rotl(hash ^ (static_cast<std::uint64_t>(bytes[offset]) * PRIME_3), 11) * PRIME_1;
+
+			hash ^= hash >> 33;
+			hash *= PRIME_2;
+			hash ^= hash >> 29;
+			return hash;
+		}
+	}
+
+	/**
+	 * Per-page hashes of the regions selected by the search constraints.
+	 * `update` reads every fingerprinted region once, re-hashes its pages and reports the address ranges which changed since the last call.
+	 * Without help from the operating system, reading the pages is the only way to tell whether they changed,
+	 * consumers of the changes get to look at the bytes of that same read instead of reading the regions again.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT>
+	class PageFingerprint {
+		struct RegionHashes {
+			std::uintptr_t address;
+			std::size_t length;
+			std::vector<std::uint64_t> pages;
+		};
+
+		const MemMgr* memory_manager;
+		SearchConstraints<typename MemMgr::RegionT> search_constraints;
+		std::vector<RegionHashes> regions; // Ascending
+
+		static RegionHashes hash_region(std::uintptr_t address, std::span<const std::byte> bytes)
+		{
+			RegionHashes hashes{ address, bytes.size(), {} };
+			hashes.pages.reserve((bytes.size() + PAGE_SIZE - 1) / PAGE_SIZE);
+			for (std::size_t offset = 0; offset < bytes.size(); offset += PAGE_SIZE)
+				hashes.pages.push_back(detail::hash_page(bytes.subspan(offset, std::min(PAGE_SIZE, bytes.size() - offset))));
+			return hashes;
+		}
+
+		std::vector<RegionHashes> hash_regions() const
+		{
+			std::vector<RegionHashes> new_regions;
+
+			for (const auto& region : memory_manager->get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+
+				detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ region };
+				new_regions.emplace_back(hash_region(region.get_address(), region_bytes.get()));
+			}
+
+			std::ranges::sort(new_regions, {}, &RegionHashes::address);
+			return new_regions;
+		}
+
+	public:
+		using Range = std::pair<std::uintptr_t, std::uintptr_t>;
+
+		static constexpr std::size_t PAGE_SIZE = 4096;
+
+		PageFingerprint(const MemMgr& memory_manager, const SearchConstraints<typename MemMgr::RegionT>& search_constraints)
+			: memory_manager(&memory_manager)
+			, search_constraints(search_constraints)
+			, regions(hash_regions())
+		{
+		}
+
+		/**
+		 * Returns the ascending [begin, end) ranges of pages which changed, adjacent pages of a region are merged.
+		 * Regions which appeared or changed their size count as changed entirely.
+		 *
+		 * For every region with changes, `on_changes(region, bytes, changes)` is called with the bytes of the whole region
+		 * and its changed ranges. The bytes are only valid during the call.
+		 */
+		template <typename F>
+			requires std::invocable<F, const typename MemMgr::RegionT&, std::span<const std::byte>, std::span<const Range>>
+		std::vector<Range> update(F&& on_changes)
+		{
+			std::vector<RegionHashes> new_regions;
+			std::vector<Range> changes;
+
+			for (const auto& region : memory_manager->get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+
+				detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ region };
+				const std::span<const std::byte> bytes = region_bytes.get();
+				RegionHashes hashes = hash_region(region.get_address(), bytes);
+
+				const std::size_t first_change = changes.size();
+				auto mark = [&changes, first_change](std::uintptr_t begin, std::uintptr_t end) {
+					// Ranges never cross region boundaries, the next region is not necessarily adjacent
+					if (changes.size() > first_change && changes.back().second == begin)
+						changes.back().second = end;
+					else
+						changes.emplace_back(begin, end);
+				};
+
+				auto previous = std::ranges::lower_bound(regions, hashes.address, {}, &RegionHashes::address);
+				if (previous == regions.end() || previous->address != hashes.address || previous->length != hashes.length) {
+					mark(hashes.address, hashes.address + hashes.length);
+				} else {
+					for (std::size_t page = 0; page < hashes.pages.size(); page++)
+						if (hashes.pages[page] != previous->pages[page])
+							mark(hashes.address + page * PAGE_SIZE, std::min(hashes.address + (page + 1) * PAGE_SIZE, hashes.address + hashes.length));
+				}
+
+				if (changes.size() > first_change)
+					on_changes(region, bytes, std::span<const Range>{ changes }.subspan(first_change));
+
+				new_regions.emplace_back(std::move(hashes));
+			}
+
+			std::ranges::sort(new_regions, {}, &RegionHashes::address);
+			regions = std::move(new_regions);
+
+			std::ranges::sort(changes);
+			return changes;
+		}
+
+		std::vector<Range> update()
+		{
+			return update([](const auto&, std::span<const std::byte>, std::span<const Range>) {});
+		}
+
+		// Whether the address is part of a fingerprinted region
+		[[nodiscard]] bool covers(std::uintptr_t address) const
+		{
+			auto it = std::ranges::upper_bound(regions, address, {}, &RegionHashes::address);
+			return it != regions.begin() && address < std::prev(it)->address + std::prev(it)->length;
+		}
+
+		[[nodiscard]] const SearchConstraints<typename MemMgr::RegionT>& get_search_constraints() const
+		{
+			return search_constraints;
+		}
+	};
+
+	/**
+	 * A signature scan which can be repeated cheaply:
+	 * Only pages whose hash changed are scanned again, hits in unchanged pages are carried over from the last result.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT>
+	class IncrementalSignatureScan {
+		const MemMgr* memory_manager;
+		SignatureScanner::PatternSignature signature;
+		PageFingerprint<MemMgr> fingerprint;
+		std::vector<std::uintptr_t> hits; // Ascending
+
+	public:
+		IncrementalSignatureScan(
+			const MemMgr& memory_manager,
+			const SignatureScanner::PatternSignature& signature,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+			: memory_manager(&memory_manager)
+			, signature(signature)
+			, fingerprint(memory_manager, search_constraints)
+		{
+			const Session<MemMgr> session = BCRL::signature(memory_manager, signature, search_constraints);
+			for (const auto& safe_pointer : session.peek())
+				hits.push_back(safe_pointer.get_pointer());
+			std::ranges::sort(hits);
+		}
+
+		// Brings the hits up to date and returns them, the changed pages are scanned from the bytes the fingerprint read anyway
+		Session<MemMgr> rescan()
+		{
+			using Range = typename PageFingerprint<MemMgr>::Range;
+
+			const std::size_t length = signature.get_elements().size();
+			const std::size_t reach = length == 0 ? 0 : length - 1; // How far a match reaches beyond its first byte
+
+			std::vector<std::uintptr_t> new_hits;
+			const auto& search_constraints = fingerprint.get_search_constraints();
+			const auto changes = fingerprint.update([&](const auto& region, std::span<const std::byte> bytes, std::span<const Range> region_changes) {
+				std::uintptr_t region_begin = region.get_address();
+				std::uintptr_t region_end = region.get_address() + bytes.size();
+				search_constraints.clamp_to_address_range(region_begin, region_end);
+
+				for (const auto& [change_begin, change_end] : region_changes) {
+					// Matches starting up to `reach` bytes in front of the change overlap it, matches starting in it may extend past it
+					const std::uintptr_t scan_begin = std::max(region_begin, change_begin > reach ? change_begin - reach : 0);
+					const std::uintptr_t scan_end = std::min(region_end, change_end + reach);
+					if (scan_begin >= scan_end)
+						continue;
+
+					const std::span<const std::byte> scanned = bytes.subspan(scan_begin - region.get_address(), scan_end - scan_begin);
+					signature.all(scanned.begin(), scanned.end(), detail::LambdaInserter([&](decltype(scanned.begin()) match) {
+						const std::uintptr_t hit = scan_begin + std::distance(scanned.begin(), match);
+						if (hit < change_end)
+							new_hits.push_back(hit);
+					}));
+				}
+			});
+
+			// Drop hits which overlap a changed range or whose region is gone
+			std::erase_if(hits, [&](std::uintptr_t hit) {
+				if (!fingerprint.covers(hit))
+					return true;
+				auto change = std::ranges::upper_bound(changes, hit + reach, {}, &Range::first);
+				return change != changes.begin() && hit < std::prev(change)->second;
+			});
+			hits.insert(hits.end(), new_hits.begin(), new_hits.end());
+
+			std::ranges::sort(hits);
+			auto [first, last] = std::ranges::unique(hits);
+			hits.erase(first, last);
+
+			return pointer_list(*memory_manager, hits);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef BCRL_PIPELINEDSCAN_HPP
+#define BCRL_PIPELINEDSCAN_HPP
+
+#include "ScanBudget.hpp"
+#include "SearchConstraints.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Selects the pipelined scan mode:
+	 * Regions are read in windows of `window_size` bytes, the next window is fetched on a background thread while the current one is being matched.
+	 * Intended for memory managers which have to copy the memory across process boundaries.
+	 */
+	struct PipelineOptions {
+		std::size_t window_size = 1024 * 1024;
+	};
+
+	namespace detail {
+		struct ScanWindow {
+			std::uintptr_t address;
+			std::size_t size; // Includes the overlap into the next window
+			std::size_t accepted; // Matches are only reported if they start within this many bytes
+		};
+
+		template <typename MemMgr>
+		std::vector<ScanWindow> plan_windows(
+			const MemMgr& memory_manager,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+			std::size_t window_size,
+			std::size_t overlap)
+		{
+			std::vector<ScanWindow> windows;
+
+			for (const auto& region : memory_manager.get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+
+				std::uintptr_t begin = region.get_address();
+				std::uintptr_t end = region.get_address() + region.get_length();
+
+				search_constraints.clamp_to_address_range(begin, end);
+
+				for (std::uintptr_t address = begin; address < end; address += window_size) {
+					const std::size_t accepted = std::min<std::size_t>(window_size, end - address);
+					// Matches may cross the window end, but never the region end, since the next region is not necessarily adjacent
+					const std::size_t size = std::min<std::size_t>(accepted + overlap, end - address);
+					windows.push_back({ address, size, accepted });
+				}
+			}
+
+			return windows;
+		}
+
+		/**
+		 * Calls `scan(bytes, window)` for every window, while the next window is being read in the background.
+		 * Every window is accounted for in the budget before it is read, the scan ends once it is exhausted.
+		 */
+		template <typename MemMgr, typename F>
+		void pipelined_scan(const MemMgr& memory_manager, const std::vector<ScanWindow>& windows, const F& scan, ScanBudget* budget = nullptr)
+		{
+			auto within_budget = [budget](const ScanWindow& window) {
+				return budget == nullptr || budget->consume(window.accepted);
+			};
+
+			if (windows.empty() || !within_budget(windows.front()))
+				return;
+
+			std::array<std::vector<std::byte>, 2> buffers;
+
+			auto read_window = [&memory_manager, &buffers](std::size_t buffer, const ScanWindow& window) {
+				buffers[buffer].resize(window.size);
+				memory_manager.read(window.address, buffers[buffer].data(), window.size);
+			};
+
+			read_window(0, windows.front());
+
+			for (std::size_t i = 0; i < windows.size(); i++) {
+				const std::size_t current = i % 2;
+
+				std::future<void> next;
+				if (i + 1 < windows.size() && within_budget(windows[i + 1]))
+					next = std::async(std::launch::async, read_window, 1 - current, std::cref(windows[i + 1]));
+
+				scan(std::span<const std::byte>{ buffers[current] }, windows[i]);
+
+				if (!next.valid())
+					break;
+				next.get();
+			}
+		}
+	}
+}
+
+#endif
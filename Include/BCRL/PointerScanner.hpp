@@ -0,0 +1,213 @@
+#ifndef BCRL_POINTERSCANNER_HPP
+#define BCRL_POINTERSCANNER_HPP
+
+#include "detail/RegionBytes.hpp"
+
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * A chain of pointers which leads from a static location to a target:
+	 * Dereference `base`, add the first offset, dereference the result, add the second offset, ...
+	 */
+	struct PointerPath {
+		std::uintptr_t base;
+		std::vector<std::size_t> offsets;
+	};
+
+	struct PointerScanOptions {
+		std::size_t max_depth = 5;
+		std::size_t max_offset = 0x1000;
+		std::size_t max_results = 10000;
+		std::size_t threads = std::max(1U, std::thread::hardware_concurrency());
+	};
+
+	/**
+	 * Reverse pointer map of memory:
+	 * Every aligned pointer-sized value, which points into a scanned region, sorted and deduplicated by the value it holds.
+	 * Building it costs a single pass over the scanned regions, after that any number of targets can be searched.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT>
+	class PointerMap {
+	public:
+		struct Entry {
+			std::uintptr_t value;
+			std::uintptr_t location;
+			bool is_static; // Location lies in a region that was allowed by the static constraints
+		};
+
+	private:
+		std::vector<Entry> entries;
+
+	public:
+		PointerMap(
+			const MemMgr& memory_manager,
+			const SearchConstraints<typename MemMgr::RegionT>& static_constraints,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().with_flags("rw*"),
+			std::size_t threads = std::max(1U, std::thread::hardware_concurrency()))
+		{
+			threads = std::max<std::size_t>(threads, 1);
+
+			std::vector<const typename MemMgr::RegionT*> regions;
+			std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ranges; // Only pointers into these are interesting
+			for (const auto& region : memory_manager.get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+				regions.push_back(&region);
+				ranges.emplace_back(region.get_address(), region.get_address() + region.get_length());
+			}
+			std::ranges::sort(ranges);
+
+			auto points_into_ranges = [&ranges](std::uintptr_t value) {
+				auto it = std::ranges::upper_bound(ranges, value, {}, &std::pair<std::uintptr_t, std::uintptr_t>::first);
+				return it != ranges.begin() && value < std::prev(it)->second;
+			};
+
+			std::mutex mutex;
+			auto worker = [&](std::size_t thread_index) {
+				std::vector<Entry> local_entries;
+				for (std::size_t i = thread_index; i < regions.size(); i += threads) {
+					const auto& region = *regions[i];
+					const bool is_static = static_constraints.allows_region(region);
+
+					detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ region };
+					std::span<const std::byte> bytes = region_bytes.get();
+
+					// Regions are page-aligned, so offsets into them are aligned as well
+					for (std::size_t offset = 0; offset + sizeof(std::uintptr_t) <= bytes.size(); offset += sizeof(std::uintptr_t)) {
+						std::uintptr_t value = 0;
+						std::memcpy(&value, bytes.data() + offset, sizeof(value));
+						if (points_into_ranges(value))
+							local_entries.push_back({ value, region.get_address() + offset, is_static });
+					}
+				}
+
+				const std::scoped_lock lock{ mutex };
+				entries.insert(entries.end(), local_entries.begin(), local_entries.end());
+			};
+
+			{
+				std::vector<std::jthread> workers;
+				for (std::size_t i = 1; i < threads; i++)
+					workers.emplace_back(worker, i);
+				worker(0);
+			}
+
+			std::ranges::sort(entries, [](const Entry& a, const Entry& b) {
+				return std::pair{ a.value, a.location } < std::pair{ b.value, b.location };
+			});
+			auto [first, last] = std::ranges::unique(entries, [](const Entry& a, const Entry& b) {
+				return a.value == b.value && a.location == b.location;
+			});
+			entries.erase(first, last);
+		}
+
+		// Entries which hold a value in [lowest, highest]
+		[[nodiscard]] std::span<const Entry> pointing_into(std::uintptr_t lowest, std::uintptr_t highest) const
+		{
+			auto begin = std::ranges::lower_bound(entries, lowest, {}, &Entry::value);
+			auto end = std::ranges::upper_bound(begin, entries.end(), highest, {}, &Entry::value);
+			return { begin, end };
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return entries.size();
+		}
+	};
+
+	/**
+	 * Finds pointer paths from static locations to `target` by a breadth-first search over the reverse pointer map.
+	 * Every address is only expanded once, so for each static location only the shortest paths are reported.
+	 */
+	template <typename MemMgr>
+	[[nodiscard]] std::vector<PointerPath> find_pointer_paths(const PointerMap<MemMgr>& map, std::uintptr_t target, const PointerScanOptions& options = {})
+	{
+		struct Node {
+			std::uintptr_t address;
+			std::size_t parent;
+			std::size_t offset; // Added to the value at `address` to reach the parent
+			bool is_static;
+		};
+
+		static constexpr std::size_t ROOT = static_cast<std::size_t>(-1);
+
+		std::vector<Node> nodes{ { target, ROOT, 0, false } };
+		std::unordered_set<std::uintptr_t> visited{ target };
+		std::vector<std::size_t> results;
+
+		std::size_t level_begin = 0;
+		for (std::size_t depth = 0; depth < options.max_depth && results.size() < options.max_results; depth++) {
+			const std::size_t level_end = nodes.size();
+			if (level_begin == level_end)
+				break;
+
+			const std::size_t threads = std::max<std::size_t>(1, std::min(options.threads, level_end - level_begin));
+			std::vector<std::vector<Node>> discovered(threads);
+
+			auto worker = [&](std::size_t thread_index) {
+				for (std::size_t i = level_begin + thread_index; i < level_end; i += threads) {
+					const std::uintptr_t address = nodes[i].address;
+					const std::uintptr_t lowest = address > options.max_offset ? address - options.max_offset : 0;
+					for (const auto& entry : map.pointing_into(lowest, address))
+						discovered[thread_index].push_back({ entry.location, i, address - entry.value, entry.is_static });
+				}
+			};
+
+			{
+				std::vector<std::jthread> workers;
+				for (std::size_t i = 1; i < threads; i++)
+					workers.emplace_back(worker, i);
+				worker(0);
+			}
+
+			for (const auto& thread_nodes : discovered)
+				for (const Node& node : thread_nodes) {
+					if (!visited.insert(node.address).second)
+						continue;
+					nodes.push_back(node);
+					if (node.is_static && results.size() < options.max_results)
+						results.push_back(nodes.size() - 1);
+				}
+
+			level_begin = level_end;
+		}
+
+		std::vector<PointerPath> paths;
+		paths.reserve(results.size());
+		for (std::size_t result : results) {
+			PointerPath path{ nodes[result].address, {} };
+			for (std::size_t node = result; nodes[node].parent != ROOT; node = nodes[node].parent)
+				path.offsets.push_back(nodes[node].offset);
+			paths.emplace_back(std::move(path));
+		}
+		return paths;
+	}
+
+	// Turns a pointer path back into a Session which can be resolved again
+	template <typename MemMgr>
+	[[nodiscard]] inline Session<MemMgr> follow(const MemMgr& memory_manager, const PointerPath& path)
+	{
+		Session<MemMgr> session = pointer(memory_manager, path.base);
+		for (std::size_t offset : path.offsets)
+			session.dereference().add(offset);
+		return session;
+	}
+}
+
+#endif
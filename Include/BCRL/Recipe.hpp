@@ -0,0 +1,533 @@
+#ifndef BCRL_RECIPE_HPP
+#define BCRL_RECIPE_HPP
+
+#include "detail/PatternText.hpp"
+
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+#include "SignatureScanner/XRefSignature.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Declarative version of SearchConstraints, which can be compared and written down as text.
+	 * Without flags, regions are required to be readable, which is the default of all Session operations.
+	 */
+	struct RecipeConstraints {
+		std::optional<std::string> name;
+		std::optional<std::string> flags; // Same format as FlagSpecification, e.g. "r-x"
+
+		[[nodiscard]] std::string to_string() const
+		{
+			std::string text;
+			if (name.has_value())
+				text += " name=" + name.value();
+			if (flags.has_value())
+				text += " flags=" + flags.value();
+			return text;
+		}
+
+		template <typename Region>
+		[[nodiscard]] SearchConstraints<Region> to_search_constraints() const
+		{
+			SearchConstraints<Region> search_constraints{};
+
+			if constexpr (MemoryManager::FlagAware<Region>) {
+				if (flags.has_value())
+					search_constraints.with_flags(flags.value().c_str());
+				else
+					search_constraints.thats_readable();
+			}
+
+			if constexpr (MemoryManager::NameAware<Region>)
+				if (name.has_value())
+					search_constraints.also([name = name.value()](const Region& r) {
+						return r.get_name() == name;
+					});
+
+			return search_constraints;
+		}
+	};
+
+	enum class RecipeXRefTypes : std::uint8_t {
+		RELATIVE,
+		ABSOLUTE,
+		RELATIVE_AND_ABSOLUTE,
+	};
+
+	/**
+	 * A Session chain written down as data.
+	 * Every step carries a key which describes it, recipes with the same leading keys share these steps in a RecipeBatch.
+	 */
+	template <typename MemMgr>
+	class Recipe {
+	public:
+		using Opener = std::function<Session<MemMgr>(const MemMgr&)>;
+		using Step = std::function<void(Session<MemMgr>&)>;
+		using Region = typename MemMgr::RegionT;
+
+	private:
+		std::string opener_key;
+		Opener opener;
+		std::vector<std::pair<std::string, Step>> steps;
+
+		static SignatureScanner::XRefTypes to_xref_types(RecipeXRefTypes types)
+		{
+			switch (types) {
+			case RecipeXRefTypes::RELATIVE:
+				return SignatureScanner::XRefTypes::relative();
+			case RecipeXRefTypes::ABSOLUTE:
+				return SignatureScanner::XRefTypes::absolute();
+			case RecipeXRefTypes::RELATIVE_AND_ABSOLUTE:
+				return SignatureScanner::XRefTypes::relative_and_absolute();
+			}
+			std::unreachable();
+		}
+
+		static std::string_view xref_types_name(RecipeXRefTypes types)
+		{
+			switch (types) {
+			case RecipeXRefTypes::RELATIVE:
+				return "relative";
+			case RecipeXRefTypes::ABSOLUTE:
+				return "absolute";
+			case RecipeXRefTypes::RELATIVE_AND_ABSOLUTE:
+				return "relative_and_absolute";
+			}
+			std::unreachable();
+		}
+
+	public:
+		Recipe(std::string opener_key, Opener&& opener)
+			: opener_key(std::move(opener_key))
+			, opener(std::move(opener))
+		{
+		}
+
+		// Openers
+		[[nodiscard]] static Recipe signature(const SignatureScanner::PatternSignature& signature, const RecipeConstraints& constraints = {})
+			requires MemoryManager::Viewable<Region>
+		{
+			return { "signature " + detail::pattern_to_string(signature) + constraints.to_string(),
+				[signature, search_constraints = constraints.to_search_constraints<Region>()](const MemMgr& memory_manager) {
+					return BCRL::signature(memory_manager, signature, search_constraints);
+				} };
+		}
+
+		[[nodiscard]] static Recipe string(std::string_view string, const RecipeConstraints& constraints = {})
+			requires MemoryManager::Viewable<Region>
+		{
+			// Deliberately shares its key with the equivalent signature, so both forms are deduplicated together
+			return signature(detail::literal_string(string), constraints);
+		}
+
+		[[nodiscard]] static Recipe pointer(std::uintptr_t pointer)
+		{
+			return { "pointer " + std::to_string(pointer), [pointer](const MemMgr& memory_manager) {
+						return BCRL::pointer(memory_manager, pointer);
+					} };
+		}
+
+		// Steps
+		Recipe& then(std::string key, Step&& step) // Arbitrary operation, the key has to uniquely describe it
+		{
+			steps.emplace_back(std::move(key), std::move(step));
+			return *this;
+		}
+
+		Recipe& add(std::size_t operand)
+		{
+			return then("add " + std::to_string(operand), [operand](Session<MemMgr>& session) {
+				session.add(operand);
+			});
+		}
+
+		Recipe& sub(std::size_t operand)
+		{
+			return then("sub " + std::to_string(operand), [operand](Session<MemMgr>& session) {
+				session.sub(operand);
+			});
+		}
+
+		Recipe& dereference()
+		{
+			return then("dereference", [](Session<MemMgr>& session) {
+				session.dereference();
+			});
+		}
+
+		Recipe& prev_signature_occurrence(const SignatureScanner::PatternSignature& signature, const RecipeConstraints& constraints = {})
+			requires MemoryManager::Viewable<Region>
+		{
+			return then("prev_signature_occurrence " + detail::pattern_to_string(signature) + constraints.to_string(),
+				[signature, search_constraints = constraints.to_search_constraints<Region>()](Session<MemMgr>& session) {
+					session.prev_signature_occurrence(signature, search_constraints);
+				});
+		}
+
+		Recipe& next_signature_occurrence(const SignatureScanner::PatternSignature& signature, const RecipeConstraints& constraints = {})
+			requires MemoryManager::Viewable<Region>
+		{
+			return then("next_signature_occurrence " + detail::pattern_to_string(signature) + constraints.to_string(),
+				[signature, search_constraints = constraints.to_search_constraints<Region>()](Session<MemMgr>& session) {
+					session.next_signature_occurrence(signature, search_constraints);
+				});
+		}
+
+		Recipe& filter(const RecipeConstraints& constraints = {})
+		{
+			return then("filter" + constraints.to_string(),
+				[search_constraints = constraints.to_search_constraints<Region>()](Session<MemMgr>& session) {
+					session.filter(search_constraints);
+				});
+		}
+
+		Recipe& find_xrefs(RecipeXRefTypes types, const RecipeConstraints& constraints = {})
+			requires MemoryManager::Viewable<Region>
+		{
+			return then("find_xrefs " + std::string{ xref_types_name(types) } + constraints.to_string(),
+				[types = to_xref_types(types), search_constraints = constraints.to_search_constraints<Region>()](Session<MemMgr>& session) {
+					session.find_xrefs(types, search_constraints);
+				});
+		}
+
+		Recipe& relative_to_absolute()
+		{
+			return then("relative_to_absolute", [](Session<MemMgr>& session) {
+				session.relative_to_absolute();
+			});
+		}
+
+		Recipe& next_instruction()
+		{
+			return then("next_instruction", [](Session<MemMgr>& session) {
+				session.next_instruction();
+			});
+		}
+
+		// Evaluation
+		[[nodiscard]] Session<MemMgr> resolve(const MemMgr& memory_manager) const
+		{
+			Session<MemMgr> session = opener(memory_manager);
+			for (const auto& [key, step] : steps)
+				step(session);
+			return session;
+		}
+
+		[[nodiscard]] const std::string& get_opener_key() const
+		{
+			return opener_key;
+		}
+
+		[[nodiscard]] const Opener& get_opener() const
+		{
+			return opener;
+		}
+
+		[[nodiscard]] const std::vector<std::pair<std::string, Step>>& get_steps() const
+		{
+			return steps;
+		}
+
+		// Describes the entire chain, two recipes with the same key resolve to the same pointers
+		[[nodiscard]] std::string get_key() const
+		{
+			std::string key = opener_key;
+			for (const auto& [step_key, step] : steps) {
+				key.push_back('\n');
+				key += step_key;
+			}
+			return key;
+		}
+	};
+
+	/**
+	 * Resolves many recipes at once.
+	 * Recipes are merged into a prefix tree by their step keys, so every shared prefix is only executed once,
+	 * its session is cloned where the recipes diverge.
+	 */
+	template <typename MemMgr>
+	class RecipeBatch {
+		struct Node {
+			const std::string* key;
+			const typename Recipe<MemMgr>::Step* step;
+			std::vector<std::size_t> children;
+			std::vector<std::size_t> finished_recipes; // Indices of recipes which end in this node
+		};
+
+		std::vector<Recipe<MemMgr>> recipes;
+
+		void visit(const std::vector<Node>& nodes, std::size_t index, Session<MemMgr>&& session, std::vector<std::optional<Session<MemMgr>>>& results) const
+		{
+			const Node& node = nodes[index];
+
+			for (std::size_t recipe : node.finished_recipes)
+				results[recipe].emplace(session.clone());
+
+			for (std::size_t i = 0; i < node.children.size(); i++) {
+				const Node& child = nodes[node.children[i]];
+				// The last branch may consume the session instead of copying it
+				Session<MemMgr> branch = i + 1 == node.children.size() ? std::move(session) : session.clone();
+				(*child.step)(branch);
+				visit(nodes, node.children[i], std::move(branch), results);
+			}
+		}
+
+	public:
+		std::size_t add(Recipe<MemMgr> recipe) // Returns the index of the recipe in the results
+		{
+			recipes.emplace_back(std::move(recipe));
+			return recipes.size() - 1;
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return recipes.size();
+		}
+
+		// Returns one session per recipe, in the order the recipes were added
+		[[nodiscard]] std::vector<Session<MemMgr>> resolve(const MemMgr& memory_manager) const
+		{
+			std::vector<Node> nodes;
+			std::vector<std::size_t> roots;
+
+			auto find_or_insert = [&nodes](std::vector<std::size_t>& siblings, const std::string& key, const auto* step) {
+				for (std::size_t sibling : siblings)
+					if (*nodes[sibling].key == key)
+						return sibling;
+				nodes.push_back({ &key, step, {}, {} });
+				siblings.push_back(nodes.size() - 1);
+				return nodes.size() - 1;
+			};
+
+			std::vector<std::size_t> root_recipes; // The recipe which provides the opener of every root
+			for (std::size_t i = 0; i < recipes.size(); i++) {
+				const Recipe<MemMgr>& recipe = recipes[i];
+
+				std::size_t root_count = roots.size();
+				std::size_t current = find_or_insert(roots, recipe.get_opener_key(), static_cast<const typename Recipe<MemMgr>::Step*>(nullptr));
+				if (roots.size() != root_count)
+					root_recipes.push_back(i);
+
+				for (const auto& [key, step] : recipe.get_steps()) {
+					// Copy the index list, since the insertion may reallocate the node vector
+					std::vector<std::size_t> children = std::move(nodes[current].children);
+					std::size_t next = find_or_insert(children, key, &step);
+					nodes[current].children = std::move(children);
+					current = next;
+				}
+
+				nodes[current].finished_recipes.push_back(i);
+			}
+
+			std::vector<std::optional<Session<MemMgr>>> results(recipes.size());
+			for (std::size_t i = 0; i < roots.size(); i++)
+				visit(nodes, roots[i], recipes[root_recipes[i]].get_opener()(memory_manager), results);
+
+			std::vector<Session<MemMgr>> sessions;
+			sessions.reserve(results.size());
+			for (std::optional<Session<MemMgr>>& result : results)
+				sessions.emplace_back(std::move(result.value()));
+			return sessions;
+		}
+	};
+
+	struct RecipeParseError {
+		std::size_t line;
+		std::string message;
+	};
+
+	/**
+	 * Parses the text form of a recipe, one operation per line, '#' starts a comment:
+	 *
+	 * 	string "You will never find me!"
+	 * 	find_xrefs relative_and_absolute name=libExampleTarget.so
+	 * 	add 4
+	 *
+	 * Openers:	signature <bytes> [constraints], string "<text>" [constraints], pointer <address>
+	 * Steps:	add <n>, sub <n>, dereference, relative_to_absolute, next_instruction, filter [constraints],
+	 * 		find_xrefs <relative|absolute|relative_and_absolute> [constraints],
+	 * 		next_signature_occurrence <bytes> [constraints], prev_signature_occurrence <bytes> [constraints]
+	 * Constraints:	name=<region name> flags=<rwx>
+	 */
+	template <typename MemMgr>
+	[[nodiscard]] std::expected<Recipe<MemMgr>, RecipeParseError> parse_recipe(std::string_view text)
+	{
+		struct Line {
+			std::vector<std::string> tokens;
+			RecipeConstraints constraints;
+		};
+
+		auto tokenize = [](std::string_view line) -> std::expected<Line, std::string> {
+			Line result;
+			std::size_t i = 0;
+			while (i < line.size()) {
+				if (line[i] == ' ' || line[i] == '\t') {
+					i++;
+					continue;
+				}
+				if (line[i] == '#')
+					break;
+
+				std::string token;
+				if (line[i] == '"') {
+					i++;
+					while (i < line.size() && line[i] != '"') {
+						if (line[i] == '\\' && i + 1 < line.size())
+							i++;
+						token.push_back(line[i++]);
+					}
+					if (i == line.size())
+						return std::unexpected("Unterminated string");
+					i++;
+					result.tokens.emplace_back(std::move(token));
+					continue;
+				}
+
+				while (i < line.size() && line[i] != ' ' && line[i] != '\t')
+					token.push_back(line[i++]);
+
+				if (token.starts_with("name="))
+					result.constraints.name = token.substr(5);
+				else if (token.starts_with("flags=")) {
+					std::string flags = token.substr(6);
+					static constexpr std::string_view DEFAULTS = "rwx";
+					if (flags.size() != 3)
+						return std::unexpected("Flags need to consist of three characters");
+					for (std::size_t j = 0; j < 3; j++)
+						if (flags[j] != DEFAULTS[j] && flags[j] != '-' && flags[j] != '*')
+							return std::unexpected("Invalid flags '" + flags + "'");
+					result.constraints.flags = std::move(flags);
+				} else
+					result.tokens.emplace_back(std::move(token));
+			}
+			return result;
+		};
+
+		auto parse_number = [](const std::string& token) -> std::optional<std::uintptr_t> {
+			std::string_view digits = token;
+			int base = 10;
+			if (digits.starts_with("0x")) {
+				digits.remove_prefix(2);
+				base = 16;
+			}
+			std::uintptr_t value = 0;
+			auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, base);
+			if (ec != std::errc{} || ptr != digits.data() + digits.size())
+				return std::nullopt;
+			return value;
+		};
+
+		auto join = [](const std::vector<std::string>& tokens) {
+			std::string joined;
+			for (std::size_t i = 1; i < tokens.size(); i++) {
+				if (i > 1)
+					joined.push_back(' ');
+				joined += tokens[i];
+			}
+			return joined;
+		};
+
+		std::optional<Recipe<MemMgr>> recipe;
+		std::size_t line_number = 0;
+
+		while (!text.empty()) {
+			line_number++;
+			std::size_t newline = text.find('\n');
+			std::string_view line_text = text.substr(0, newline);
+			text = newline == std::string_view::npos ? std::string_view{} : text.substr(newline + 1);
+
+			auto line = tokenize(line_text);
+			if (!line.has_value())
+				return std::unexpected(RecipeParseError{ line_number, line.error() });
+			if (line->tokens.empty())
+				continue;
+
+			const std::vector<std::string>& tokens = line->tokens;
+			const std::string& operation = tokens.front();
+			const RecipeConstraints& constraints = line->constraints;
+
+			auto error = [line_number](std::string message) {
+				return std::unexpected(RecipeParseError{ line_number, std::move(message) });
+			};
+
+			if (!recipe.has_value()) {
+				if (operation == "signature") {
+					auto signature = detail::parse_array_of_bytes(join(tokens));
+					if (!signature.has_value())
+						return error("Invalid signature");
+					recipe.emplace(Recipe<MemMgr>::signature(signature.value(), constraints));
+				} else if (operation == "string") {
+					if (tokens.size() != 2)
+						return error("'string' expects exactly one quoted string");
+					recipe.emplace(Recipe<MemMgr>::string(tokens[1], constraints));
+				} else if (operation == "pointer") {
+					std::optional<std::uintptr_t> address = tokens.size() == 2 ? parse_number(tokens[1]) : std::nullopt;
+					if (!address.has_value())
+						return error("'pointer' expects an address");
+					recipe.emplace(Recipe<MemMgr>::pointer(address.value()));
+				} else
+					return error("Expected an opener, got '" + operation + "'");
+				continue;
+			}
+
+			if (operation == "add" || operation == "sub") {
+				std::optional<std::uintptr_t> operand = tokens.size() == 2 ? parse_number(tokens[1]) : std::nullopt;
+				if (!operand.has_value())
+					return error("'" + operation + "' expects a number");
+				if (operation == "add")
+					recipe->add(operand.value());
+				else
+					recipe->sub(operand.value());
+			} else if (operation == "dereference")
+				recipe->dereference();
+			else if (operation == "relative_to_absolute")
+				recipe->relative_to_absolute();
+			else if (operation == "next_instruction")
+				recipe->next_instruction();
+			else if (operation == "filter")
+				recipe->filter(constraints);
+			else if (operation == "find_xrefs") {
+				std::string_view types = tokens.size() == 2 ? std::string_view{ tokens[1] } : "relative_and_absolute";
+				if (types == "relative")
+					recipe->find_xrefs(RecipeXRefTypes::RELATIVE, constraints);
+				else if (types == "absolute")
+					recipe->find_xrefs(RecipeXRefTypes::ABSOLUTE, constraints);
+				else if (types == "relative_and_absolute")
+					recipe->find_xrefs(RecipeXRefTypes::RELATIVE_AND_ABSOLUTE, constraints);
+				else
+					return error("Unknown xref types '" + std::string{ types } + "'");
+			} else if (operation == "next_signature_occurrence" || operation == "prev_signature_occurrence") {
+				auto signature = detail::parse_array_of_bytes(join(tokens));
+				if (!signature.has_value())
+					return error("Invalid signature");
+				if (operation == "next_signature_occurrence")
+					recipe->next_signature_occurrence(signature.value(), constraints);
+				else
+					recipe->prev_signature_occurrence(signature.value(), constraints);
+			} else
+				return error("Unknown operation '" + operation + "'");
+		}
+
+		if (!recipe.has_value())
+			return std::unexpected(RecipeParseError{ line_number, "Recipe is empty" });
+
+		return std::move(recipe.value());
+	}
+}
+
+#endif
@@ -0,0 +1,298 @@
+#ifndef BCRL_RESOLUTIONCACHE_HPP
+#define BCRL_RESOLUTIONCACHE_HPP
+
+#include "Recipe.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	// Changes whenever a region is mapped, unmapped or changes its permissions
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::LengthAware<typename MemMgr::RegionT>
+	[[nodiscard]] std::uint64_t layout_fingerprint(const MemMgr& memory_manager)
+	{
+		std::uint64_t hash = 0xCBF29CE484222325; // FNV-1a
+		auto mix = [&hash](std::uint64_t value) {
+			hash = (hash ^ value) * 0x100000001B3;
+		};
+
+		for (const auto& region : memory_manager.get_layout()) {
+			mix(region.get_address());
+			mix(region.get_length());
+			if constexpr (MemoryManager::FlagAware<typename MemMgr::RegionT>)
+				mix(region.get_flags().is_readable() | region.get_flags().is_writeable() << 1 | region.get_flags().is_executable() << 2);
+		}
+
+		return hash;
+	}
+
+	/**
+	 * Resolution results shared between threads.
+	 *
+	 * Lookups don't take a lock, the table is a fixed-size open-addressing hash table of atomic entry pointers.
+	 * Once it is full, further keys go to an overflow map behind a mutex, which keeps the guarantees but not the lock-freedom.
+	 * Every key is only computed once per generation, concurrent requesters of the same key wait for the first computation.
+	 * A computation which threw is rethrown to its waiters, the next call computes the key again.
+	 * A result whose scan ran out of budget is returned to later callers with `is_budget_exceeded()` set as well.
+	 * After `sync_layout()` call `update_layout_generation()`, if the mapping set changed all entries go stale.
+	 *
+	 * Entries which get replaced are freed as soon as no lookup is running. Their number is bounded by the replacements which happen
+	 * while lookups overlap without pause, usually one per key and generation.
+	 */
+	template <typename MemMgr>
+	class ResolutionCache {
+		enum class State : std::uint8_t {
+			COMPUTING,
+			READY,
+			FAILED,
+		};
+
+		struct Entry {
+			std::size_t hash;
+			std::string key;
+			std::uint64_t generation;
+			std::atomic<State> state{ State::COMPUTING };
+			std::vector<std::uintptr_t> result;
+			bool budget_exceeded = false; // The result is partial, waiters have to see that as well
+			std::exception_ptr exception;
+
+			Entry(std::size_t hash, std::string_view key, std::uint64_t generation)
+				: hash(hash)
+				, key(key)
+				, generation(generation)
+			{
+			}
+		};
+
+		const MemMgr* memory_manager;
+		std::size_t capacity;
+		std::unique_ptr<std::atomic<Entry*>[]> slots;
+		std::atomic<std::uint64_t> generation{ 0 };
+		std::atomic<std::uint64_t> fingerprint;
+
+		// Replaced entries may still be used by lookups which started before, so they are freed once no lookup is running
+		std::atomic<std::size_t> lookups{ 0 };
+		std::mutex retired_mutex;
+		std::vector<std::unique_ptr<Entry>> retired;
+
+		class Lookup {
+			ResolutionCache* cache;
+
+		public:
+			explicit Lookup(ResolutionCache& cache)
+				: cache(&cache)
+			{
+				cache.lookups.fetch_add(1, std::memory_order_seq_cst);
+			}
+
+			Lookup(const Lookup&) = delete;
+			Lookup& operator=(const Lookup&) = delete;
+
+			~Lookup()
+			{
+				if (cache->lookups.fetch_sub(1, std::memory_order_seq_cst) == 1)
+					cache->reclaim();
+			}
+		};
+
+		struct StringHash {
+			// NOLINTNEXTLINE(readability-identifier-naming)
+			using is_transparent = void;
+
+			std::size_t operator()(std::string_view string) const
+			{
+				return std::hash<std::string_view>{}(string);
+			}
+		};
+
+		std::mutex overflow_mutex;
+		std::unordered_map<std::string, std::unique_ptr<Entry>, StringHash, std::equal_to<>> overflow;
+
+		// Entries of a newer generation are valid as well, they were published after this thread read the generation
+		static bool is_reusable(const Entry& entry, std::uint64_t current_generation)
+		{
+			return entry.generation >= current_generation && entry.state.load(std::memory_order_acquire) != State::FAILED;
+		}
+
+		void retire(std::unique_ptr<Entry> entry)
+		{
+			const std::scoped_lock lock{ retired_mutex };
+			retired.emplace_back(std::move(entry));
+		}
+
+		void reclaim()
+		{
+			std::vector<std::unique_ptr<Entry>> reclaimable;
+			{
+				const std::scoped_lock lock{ retired_mutex };
+				// Retired entries were unlinked before they were retired, so lookups starting from now on can't reach them.
+				// Lookups which could have reached them started earlier and are still counted.
+				if (lookups.load(std::memory_order_seq_cst) != 0)
+					return; // The last of them reclaims instead
+				reclaimable.swap(retired);
+			}
+		}
+
+		Session<MemMgr> wait_for(const Entry& entry) const
+		{
+			State state = entry.state.load(std::memory_order_acquire);
+			while (state == State::COMPUTING) {
+				entry.state.wait(State::COMPUTING, std::memory_order_acquire);
+				state = entry.state.load(std::memory_order_acquire);
+			}
+
+			if (state == State::FAILED)
+				std::rethrow_exception(entry.exception);
+
+			Session<MemMgr> session = pointer_list(*memory_manager, entry.result);
+			if (entry.budget_exceeded)
+				session.mark_budget_exceeded();
+			return session;
+		}
+
+		template <typename F>
+		Session<MemMgr> compute(Entry& entry, const F& computation) const
+		{
+			try {
+				Session<MemMgr> session = computation(*memory_manager);
+				entry.result.reserve(session.peek().size());
+				for (const auto& safe_pointer : session.peek())
+					entry.result.push_back(safe_pointer.get_pointer());
+				entry.budget_exceeded = session.is_budget_exceeded();
+				entry.state.store(State::READY, std::memory_order_release);
+				entry.state.notify_all();
+				return session;
+			} catch (...) {
+				entry.exception = std::current_exception();
+				entry.state.store(State::FAILED, std::memory_order_release);
+				entry.state.notify_all();
+				throw;
+			}
+		}
+
+	public:
+		explicit ResolutionCache(const MemMgr& memory_manager, std::size_t capacity = 1024)
+			: memory_manager(&memory_manager)
+			, capacity(std::bit_ceil(capacity))
+			, slots(std::make_unique<std::atomic<Entry*>[]>(this->capacity))
+			, fingerprint(layout_fingerprint(memory_manager))
+		{
+		}
+
+		ResolutionCache(const ResolutionCache&) = delete;
+		ResolutionCache& operator=(const ResolutionCache&) = delete;
+
+		~ResolutionCache()
+		{
+			for (std::size_t i = 0; i < capacity; i++)
+				delete slots[i].load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * Returns the cached result for the key, or computes it.
+		 * The key has to describe the computation including its constraints, e.g. Recipe::get_key.
+		 */
+		template <typename F>
+			requires std::is_invocable_r_v<Session<MemMgr>, F, const MemMgr&>
+		[[nodiscard]] Session<MemMgr> resolve(std::string_view key, const F& computation)
+		{
+			const Lookup lookup{ *this };
+			const std::size_t hash = std::hash<std::string_view>{}(key);
+			const std::uint64_t current_generation = generation.load(std::memory_order_acquire);
+
+			for (std::size_t probe = 0; probe < capacity;) {
+				std::atomic<Entry*>& slot = slots[(hash + probe) & (capacity - 1)];
+				Entry* entry = slot.load(std::memory_order_acquire);
+
+				if (entry == nullptr) {
+					auto fresh = std::make_unique<Entry>(hash, key, current_generation);
+					if (slot.compare_exchange_strong(entry, fresh.get(), std::memory_order_acq_rel))
+						return compute(*fresh.release(), computation);
+					// Somebody else claimed the slot in the meantime, `entry` now holds their entry
+				}
+
+				if (entry->hash != hash || entry->key != key) {
+					probe++;
+					continue;
+				}
+
+				if (is_reusable(*entry, current_generation))
+					return wait_for(*entry);
+
+				// The entry was computed for an older layout or failed, replace it
+				auto fresh = std::make_unique<Entry>(hash, key, current_generation);
+				if (slot.compare_exchange_strong(entry, fresh.get(), std::memory_order_acq_rel)) {
+					retire(std::unique_ptr<Entry>{ entry });
+					return compute(*fresh.release(), computation);
+				}
+				// Lost the race, look at the slot again
+			}
+
+			// The table is full
+			Entry* entry = nullptr;
+			bool computes = false;
+			{
+				const std::scoped_lock lock{ overflow_mutex };
+				auto it = overflow.find(key);
+				if (it == overflow.end() || !is_reusable(*it->second, current_generation)) {
+					auto fresh = std::make_unique<Entry>(hash, key, current_generation);
+					if (it == overflow.end())
+						it = overflow.emplace(std::string{ key }, nullptr).first;
+					else
+						retire(std::move(it->second));
+					it->second = std::move(fresh);
+					computes = true;
+				}
+				entry = it->second.get();
+			}
+			return computes ? compute(*entry, computation) : wait_for(*entry);
+		}
+
+		[[nodiscard]] Session<MemMgr> resolve(const Recipe<MemMgr>& recipe)
+		{
+			return resolve(recipe.get_key(), [&recipe](const MemMgr& memory_manager) {
+				return recipe.resolve(memory_manager);
+			});
+		}
+
+		// Marks all entries as stale
+		void invalidate()
+		{
+			generation.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		// Invalidates all entries if the mapping set differs from the last call, returns whether that was the case
+		bool update_layout_generation()
+		{
+			const std::uint64_t current = layout_fingerprint(*memory_manager);
+			if (fingerprint.exchange(current, std::memory_order_acq_rel) == current)
+				return false;
+
+			invalidate();
+			return true;
+		}
+
+		[[nodiscard]] std::uint64_t get_generation() const
+		{
+			return generation.load(std::memory_order_acquire);
+		}
+	};
+}
+
+#endif
@@ -0,0 +1,249 @@
+#ifndef BCRL_RTTIINDEX_HPP
+#define BCRL_RTTIINDEX_HPP
+
+#include "detail/RegionBytes.hpp"
+
+#include "SafePointer.hpp"
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Index of the run-time type information, which Itanium C++ ABI compilers (GCC, Clang) emit for polymorphic classes.
+	 *
+	 * All selected regions are read once, then searched for
+	 * - typeinfo names: mangled type names such as "N3foo3BarE"
+	 * - typeinfo objects: A vtable pointer followed by a pointer to a typeinfo name
+	 * - vtables: The offset-to-top, followed by a pointer to a typeinfo object, followed by the virtual function pointers
+	 * This replaces the usual string scan, xref to the typeinfo and xref to the vtable for every class.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT> && MemoryManager::FlagAware<typename MemMgr::RegionT>
+	class RttiIndex {
+	public:
+		struct Vtable {
+			std::uintptr_t address; // The address point, which is what objects point to; Its first slot
+			std::ptrdiff_t offset_to_top; // Zero for the primary vtable, negative for secondary vtables of multiple inheritance
+			std::size_t slot_count;
+		};
+
+		struct Class {
+			std::string name; // Demangled, e.g. "foo::Bar"
+			std::string mangled_name;
+			std::uintptr_t type_info;
+			std::vector<Vtable> vtables;
+		};
+
+	private:
+		struct StringHash {
+			// NOLINTNEXTLINE(readability-identifier-naming)
+			using is_transparent = void;
+
+			std::size_t operator()(std::string_view string) const
+			{
+				return std::hash<std::string_view>{}(string);
+			}
+		};
+
+		const MemMgr* memory_manager;
+		std::vector<Class> classes;
+		std::unordered_map<std::string, std::vector<std::size_t>, StringHash, std::equal_to<>> by_name; // Names can repeat across modules
+
+		static constexpr bool is_mangled_name_character(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+		}
+
+		// Class types are mangled as a source name ("3Foo"), a nested name ("N...E"), a std abbreviation ("St...") or a local name ("Z...E")
+		static constexpr bool can_start_class_name(char c)
+		{
+			return (c >= '0' && c <= '9') || c == 'N' || c == 'S' || c == 'Z';
+		}
+
+		static std::optional<std::string> demangle(const std::string& mangled_name)
+		{
+			int status = 0;
+			std::unique_ptr<char, decltype(&std::free)> demangled{ abi::__cxa_demangle(mangled_name.c_str(), nullptr, nullptr, &status), &std::free };
+			if (status != 0 || !demangled)
+				return std::nullopt;
+			return std::string{ demangled.get() };
+		}
+
+		bool is_executable(std::uintptr_t address) const
+		{
+			auto* region = memory_manager->get_layout().find_region(address);
+			return region && region->get_flags().is_executable();
+		}
+
+	public:
+		explicit RttiIndex(
+			const MemMgr& memory_manager,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().with_flags("r--"))
+			: memory_manager(&memory_manager)
+		{
+			using Bytes = detail::RegionBytes<typename MemMgr::RegionT>;
+
+			struct ScannedRegion {
+				std::uintptr_t address;
+				std::unique_ptr<Bytes> bytes;
+			};
+
+			// Every region is read once, all passes below work on these bytes
+			std::vector<ScannedRegion> regions;
+			for (const auto& region : memory_manager.get_layout())
+				if (search_constraints.allows_region(region))
+					regions.push_back({ region.get_address(), std::make_unique<Bytes>(region) });
+			std::ranges::sort(regions, {}, &ScannedRegion::address);
+
+			auto for_each_word = [&regions](const auto& callback) {
+				for (const ScannedRegion& region : regions) {
+					std::span<const std::byte> bytes = region.bytes->get();
+					// Regions are page-aligned, so offsets into them are aligned as well
+					for (std::size_t offset = 0; offset + sizeof(std::uintptr_t) <= bytes.size(); offset += sizeof(std::uintptr_t))
+						callback(region.address + offset, bytes.subspan(offset));
+				}
+			};
+
+			auto word_at = [](std::span<const std::byte> bytes, std::size_t index) -> std::optional<std::uintptr_t> {
+				if ((index + 1) * sizeof(std::uintptr_t) > bytes.size())
+					return std::nullopt;
+				std::uintptr_t word = 0;
+				std::memcpy(&word, bytes.data() + index * sizeof(std::uintptr_t), sizeof(word));
+				return word;
+			};
+
+			// Pass 1: Candidates for typeinfo names
+			std::unordered_map<std::uintptr_t, std::string> names;
+			for (const ScannedRegion& region : regions) {
+				std::span<const std::byte> bytes = region.bytes->get();
+				for (std::size_t offset = 0; offset < bytes.size(); offset++) {
+					if (offset > 0 && bytes[offset - 1] != std::byte{ 0 })
+						continue;
+
+					// Types which aren't guaranteed to be unique across modules have their name prefixed with '*'
+					const std::size_t begin = offset < bytes.size() && static_cast<char>(bytes[offset]) == '*' ? offset + 1 : offset;
+					if (begin >= bytes.size() || !can_start_class_name(static_cast<char>(bytes[begin])))
+						continue;
+
+					std::size_t end = begin;
+					while (end < bytes.size() && is_mangled_name_character(static_cast<char>(bytes[end])))
+						end++;
+					if (end == bytes.size() || bytes[end] != std::byte{ 0 } || end - begin < 2)
+						continue;
+
+					names.emplace(region.address + offset, std::string{ reinterpret_cast<const char*>(bytes.data() + begin), end - begin });
+				}
+			}
+
+			// Pass 2: Typeinfo objects, their second word points to the name
+			std::unordered_map<std::uintptr_t, std::size_t> type_infos; // Address to index in `classes`
+			for_each_word([&](std::uintptr_t address, std::span<const std::byte> bytes) {
+				const std::optional<std::uintptr_t> name_pointer = word_at(bytes, 1);
+				if (!name_pointer)
+					return;
+				auto name = names.find(*name_pointer);
+				if (name == names.end())
+					return;
+
+				std::optional<std::string> demangled = demangle(name->second);
+				if (!demangled)
+					return;
+
+				type_infos.emplace(address, classes.size());
+				classes.push_back({ std::move(*demangled), name->second, address, {} });
+			});
+
+			// Pass 3: Vtables, the typeinfo pointer is preceded by the offset-to-top and followed by the slots
+			for_each_word([&](std::uintptr_t address, std::span<const std::byte> bytes) {
+				const std::optional<std::uintptr_t> type_info_pointer = word_at(bytes, 1);
+				if (!type_info_pointer)
+					return;
+				auto type_info = type_infos.find(*type_info_pointer);
+				if (type_info == type_infos.end())
+					return;
+
+				const auto offset_to_top = static_cast<std::ptrdiff_t>(*word_at(bytes, 0));
+				if (offset_to_top > 0 || offset_to_top % static_cast<std::ptrdiff_t>(sizeof(std::uintptr_t)) != 0)
+					return;
+
+				std::size_t slot_count = 0;
+				for (std::optional<std::uintptr_t> slot; (slot = word_at(bytes, 2 + slot_count)) && is_executable(*slot);)
+					slot_count++;
+
+				classes[type_info->second].vtables.push_back({ address + 2 * sizeof(std::uintptr_t), offset_to_top, slot_count });
+			});
+
+			for (std::size_t i = 0; i < classes.size(); i++)
+				by_name[classes[i].name].push_back(i);
+		}
+
+		// Every class with this name, there is one per module which contains its typeinfo
+		[[nodiscard]] std::vector<const Class*> find(std::string_view name) const
+		{
+			std::vector<const Class*> matches;
+			if (auto it = by_name.find(name); it != by_name.end())
+				for (const std::size_t i : it->second)
+					matches.push_back(&classes[i]);
+			return matches;
+		}
+
+		[[nodiscard]] const std::vector<Class>& get_classes() const
+		{
+			return classes;
+		}
+
+		[[nodiscard]] constexpr const MemMgr& get_memory_manager() const
+		{
+			return *memory_manager;
+		}
+	};
+
+	// Opener for the primary vtables of the classes with this name, the session points to their first slots
+	template <typename MemMgr>
+	[[nodiscard]] inline Session<MemMgr> vtable_for(const RttiIndex<MemMgr>& index, std::string_view name)
+	{
+		std::vector<std::uintptr_t> vtables;
+		for (const auto* c : index.find(name))
+			for (const auto& vtable : c->vtables)
+				if (vtable.offset_to_top == 0)
+					vtables.push_back(vtable.address);
+		return pointer_list(index.get_memory_manager(), vtables);
+	}
+
+	// Opener for the virtual functions of the classes with this name, every slot of a primary vtable is fetched with a single read
+	template <typename MemMgr>
+	[[nodiscard]] inline Session<MemMgr> virtual_functions(const RttiIndex<MemMgr>& index, std::string_view name)
+	{
+		std::vector<std::uintptr_t> functions;
+		for (const auto* c : index.find(name))
+			for (const auto& vtable : c->vtables) {
+				if (vtable.offset_to_top != 0)
+					continue;
+
+				if (auto slots = SafePointer{ index.get_memory_manager(), vtable.address }.template read_array<std::uintptr_t>(vtable.slot_count))
+					functions.insert(functions.end(), slots->begin(), slots->end());
+			}
+		return pointer_list(index.get_memory_manager(), functions);
+	}
+}
+
+#endif
@@ -2,7 +2,13 @@
 #define BCRL_SAFEPOINTER_HPP
 
 #include "detail/LambdaInserter.hpp"
+#include "detail/MaskedPattern.hpp"
+#include "detail/RegionBytes.hpp"
+#include "detail/ScanKernel.hpp"
 
+#include "FixedSignature.hpp"
+#include "PipelinedScan.hpp"
+#include "ScanBudget.hpp"
 #include "SearchConstraints.hpp"
 
 #include "MemoryManager/MemoryManager.hpp"
@@ -20,11 +26,23 @@
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <limits>
 #include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
 namespace BCRL {
+	namespace detail {
+		// Satisfied by FunctionIndex, FunctionIndex.hpp has to be included to use the call graph operations
+		template <typename Index>
+		concept CallGraph = requires(const Index& index, std::uintptr_t address) {
+			{ index.containing_function(address) } -> std::same_as<std::optional<std::uintptr_t>>;
+			index.callees_of(address);
+			index.callers_of(address);
+		};
+	}
+
 	template <typename MemMgr>
 		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Reader<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::LengthAware<typename MemMgr::RegionT>
 	class SafePointer { // A pointer which can't cause read access violations
@@ -48,6 +66,8 @@ namespace BCRL {
 
 			std::uintptr_t p = pointer;
 			std::uintptr_t end = pointer + length;
+			if (end < p)
+				return false; // Wraps around the address space
 
 			while (end > p) {
 				auto* region = memory_manager->get_layout().find_region(p);
@@ -81,6 +101,30 @@ namespace BCRL {
 			return std::nullopt;
 		}
 
+		// Reads `count` consecutive values, the whole range is validated once and read in a single call
+		template <typename T>
+			requires std::is_trivially_copyable_v<T>
+		[[nodiscard]] std::optional<std::vector<T>> read_array(std::size_t count) const
+		{
+			// The size in bytes has to be representable, validate before allocating for it
+			if (count > std::numeric_limits<std::size_t>::max() / sizeof(T) || !is_valid(count * sizeof(T)))
+				return std::nullopt;
+
+			std::vector<T> values(count);
+			memory_manager->read(pointer, values.data(), count * sizeof(T));
+			return values;
+		}
+
+		// Zero-copy version of read_array for memory of the own process, the span stays valid as long as the memory stays mapped
+		template <typename T>
+			requires std::is_trivially_copyable_v<T> && MemoryManager::LocalAware<MemMgr> && MemMgr::IS_LOCAL
+		[[nodiscard]] std::optional<std::span<const T>> view_array(std::size_t count) const
+		{
+			if (pointer % alignof(T) != 0 || count > std::numeric_limits<std::size_t>::max() / sizeof(T) || !is_valid(count * sizeof(T)))
+				return std::nullopt;
+			return std::span<const T>{ reinterpret_cast<const T*>(pointer), count };
+		}
+
 		SafePointer& invalidate() // Marks safe pointer as invalid
 		{
 			invalid = true;
@@ -116,48 +160,110 @@ namespace BCRL {
 		}
 
 		// Patterns
-		// Previous occurrence of pattern signature
+		// Previous occurrence of pattern signature, which ends before the current address and starts at most `max_distance` bytes before it
 		SafePointer& prev_signature_occurrence(
 			const SignatureScanner::PatternSignature& signature,
+			std::size_t max_distance,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 			requires MemoryManager::Viewable<typename MemMgr::RegionT>
+		{
+			if constexpr (detail::ScanKernels<MemMgr>::IS_COMPILED)
+				return detail::ScanKernels<MemMgr>::prev_signature_occurrence(*this, signature, max_distance, search_constraints);
+			else
+				return prev_signature_occurrence(detail::KernelImplementation{}, signature, max_distance, search_constraints);
+		}
+
+	private:
+		friend struct detail::ScanKernels<MemMgr>;
+
+		SafePointer& prev_signature_occurrence(
+			detail::KernelImplementation /*unused*/,
+			const SignatureScanner::PatternSignature& signature,
+			std::size_t max_distance,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints)
+			requires MemoryManager::Viewable<typename MemMgr::RegionT>
 		{
 			auto* region = memory_manager->get_layout().find_region(pointer);
 			if (!region || !search_constraints.allows_region(*region))
 				return invalidate();
 
-			auto view = region->view();
+			detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ *region };
+			std::span<const std::byte> bytes = region_bytes.get();
 
-			auto begin = view.cbegin();
-			auto end = view.cend();
+			auto begin = bytes.begin();
+			auto end = bytes.end();
 
 			std::uintptr_t pointer_end = region->get_address() + region->get_length();
 
 			if (pointer < pointer_end)
 				std::advance(end, pointer - pointer_end);
 
-			search_constraints.clamp_to_address_range(*region, view.cbegin(), begin, end);
-
-			auto rbegin = std::make_reverse_iterator(end);
-			auto rend = std::make_reverse_iterator(begin);
+			search_constraints.clamp_to_address_range(*region, bytes.begin(), begin, end);
 
-			auto hit = signature.prev(rbegin, rend);
+			if (begin >= end)
+				return invalidate();
 
-			if (hit == rend)
+			const std::uintptr_t haystack_address = region->get_address() + std::distance(bytes.begin(), begin);
+			std::span<const std::byte> haystack{ begin, end };
+
+			std::size_t lowest_start = 0;
+			if (pointer - haystack_address > max_distance)
+				lowest_start = pointer - haystack_address - max_distance;
+
+			const detail::MaskedPattern pattern{ signature };
+			std::size_t hit = haystack.size();
+
+			if (ScanBudget* budget = search_constraints.get_budget()) {
+				const std::size_t overlap = signature.get_elements().empty() ? 0 : signature.get_elements().size() - 1;
+				// Backwards in chunks, every chunk covers the matches which start in [chunk_begin, chunk_end)
+				for (std::size_t chunk_end = haystack.size(); chunk_end > lowest_start && hit == haystack.size();) {
+					const std::size_t chunk_begin = std::max(lowest_start, chunk_end > detail::BUDGET_CHUNK_SIZE ? chunk_end - detail::BUDGET_CHUNK_SIZE : 0);
+					if (!budget->consume(chunk_end - chunk_begin))
+						return invalidate();
+
+					std::span<const std::byte> chunk = haystack.first(std::min(haystack.size(), chunk_end + overlap));
+					if (std::size_t found = pattern.prev(chunk, chunk_begin); found != chunk.size())
+						hit = found;
+					chunk_end = chunk_begin;
+				}
+			} else
+				hit = pattern.prev(haystack, lowest_start);
+
+			if (hit == haystack.size())
 				return invalidate();
 
-			pointer = region->get_address()
-				+ region->get_length()
-				- 1
-				- std::distance(std::make_reverse_iterator(view.cend()), hit);
+			pointer = haystack_address + hit;
 			return revalidate();
 		}
 
+	public:
+		// Previous occurrence of pattern signature
+		SafePointer& prev_signature_occurrence(
+			const SignatureScanner::PatternSignature& signature,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+			requires MemoryManager::Viewable<typename MemMgr::RegionT>
+		{
+			return prev_signature_occurrence(signature, std::numeric_limits<std::size_t>::max(), search_constraints);
+		}
+
 		// Next occurrence of pattern signature
 		SafePointer& next_signature_occurrence(
 			const SignatureScanner::PatternSignature& signature,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 			requires MemoryManager::Viewable<typename MemMgr::RegionT>
+		{
+			if constexpr (detail::ScanKernels<MemMgr>::IS_COMPILED)
+				return detail::ScanKernels<MemMgr>::next_signature_occurrence(*this, signature, search_constraints);
+			else
+				return next_signature_occurrence(detail::KernelImplementation{}, signature, search_constraints);
+		}
+
+	private:
+		SafePointer& next_signature_occurrence(
+			detail::KernelImplementation /*unused*/,
+			const SignatureScanner::PatternSignature& signature,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints)
+			requires MemoryManager::Viewable<typename MemMgr::RegionT>
 		{
 			auto* region = memory_manager->get_layout().find_region(pointer);
 			if (!region || !search_constraints.allows_region(*region))
@@ -173,12 +279,60 @@ namespace BCRL {
 
 			search_constraints.clamp_to_address_range(*region, view.cbegin(), begin, end);
 
-			auto hit = signature.next(begin, end);
+			std::optional<decltype(begin)> hit;
+			const std::size_t overlap = signature.get_elements().empty() ? 0 : signature.get_elements().size() - 1;
+			detail::for_each_chunk(begin, end, overlap, search_constraints.get_budget(), [&](auto chunk_begin, auto chunk_end, auto accepted_end) {
+				auto found = signature.next(chunk_begin, chunk_end);
+				if (found != chunk_end && std::distance(chunk_begin, found) < std::distance(chunk_begin, accepted_end))
+					hit = found;
+				return !hit.has_value();
+			});
 
-			if (hit == end)
+			if (!hit.has_value())
 				return invalidate();
 
-			pointer = region->get_address() + std::distance(view.cbegin(), hit);
+			pointer = region->get_address() + std::distance(view.cbegin(), *hit);
+			return revalidate();
+		}
+
+	public:
+		// Next occurrence of a compile-time pattern signature
+		SafePointer& next_signature_occurrence(
+			FixedSignature auto signature,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+			requires MemoryManager::Viewable<typename MemMgr::RegionT>
+		{
+			auto* region = memory_manager->get_layout().find_region(pointer);
+			if (!region || !search_constraints.allows_region(*region))
+				return invalidate();
+
+			detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ *region };
+			std::span<const std::byte> bytes = region_bytes.get();
+
+			auto begin = bytes.begin();
+			auto end = bytes.end();
+
+			if (pointer > region->get_address())
+				std::advance(begin, pointer - region->get_address());
+
+			search_constraints.clamp_to_address_range(*region, bytes.begin(), begin, end);
+
+			if (begin >= end)
+				return invalidate();
+
+			std::optional<std::size_t> hit;
+			detail::for_each_chunk(begin, end, decltype(signature)::SIZE - 1, search_constraints.get_budget(), [&](auto chunk_begin, auto chunk_end, auto accepted_end) {
+				std::span<const std::byte> chunk{ chunk_begin, chunk_end };
+				const std::size_t found = signature.next(chunk);
+				if (found < static_cast<std::size_t>(std::distance(chunk_begin, accepted_end)))
+					hit = std::distance(begin, chunk_begin) + found;
+				return !hit.has_value();
+			});
+
+			if (!hit.has_value())
+				return invalidate();
+
+			pointer = region->get_address() + std::distance(bytes.begin(), begin) + *hit;
 			return revalidate();
 		}
 
@@ -192,6 +346,14 @@ namespace BCRL {
 			return signature.does_match(&bytes[0], &bytes[length]);
 		}
 
+		[[nodiscard]] bool does_match(FixedSignature auto signature) const
+		{
+			std::array<std::byte, decltype(signature)::SIZE> bytes;
+			if (!read(bytes.data(), bytes.size()))
+				return false;
+			return signature.matches(bytes.data());
+		}
+
 		// X86
 	private:
 		static constexpr bool IS_64_BIT = sizeof(void*) == 8;
@@ -200,12 +362,11 @@ namespace BCRL {
 			: LengthDisassembler::MachineMode::LONG_COMPATIBILITY_MODE;
 		using RelAddrType = std::conditional_t<IS_64_BIT, int32_t, int16_t>;
 
-	public:
-		// Since there can be multiple xrefs, this returns multiple addresses
 		[[nodiscard]] std::vector<SafePointer> find_xrefs(
+			detail::KernelImplementation /*unused*/,
 			SignatureScanner::XRefTypes types,
 			std::uint8_t instruction_length,
-			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable()) const
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints) const
 			requires MemoryManager::Viewable<typename MemMgr::RegionT>
 		{
 			std::vector<SafePointer> new_pointers;
@@ -222,15 +383,36 @@ namespace BCRL {
 
 				search_constraints.clamp_to_address_range(region, view.cbegin(), begin, end);
 
-				signature.all(begin, end, detail::LambdaInserter([&](decltype(begin) match) {
-					new_pointers.emplace_back(*memory_manager, region.get_address() + std::distance(view.cbegin(), match));
-				}),
-					region.get_address() + std::distance(view.cbegin(), begin));
+				const bool within_budget = detail::for_each_chunk(begin, end, sizeof(std::uintptr_t) - 1, search_constraints.get_budget(), [&](auto chunk_begin, auto chunk_end, auto accepted_end) {
+					const auto accepted = std::distance(chunk_begin, accepted_end);
+					signature.all(chunk_begin, chunk_end, detail::LambdaInserter([&](decltype(begin) match) {
+						if (std::distance(chunk_begin, match) < accepted)
+							new_pointers.emplace_back(*memory_manager, region.get_address() + std::distance(view.cbegin(), match));
+					}),
+						region.get_address() + std::distance(view.cbegin(), chunk_begin));
+					return true;
+				});
+				if (!within_budget)
+					break;
 			}
 
 			return new_pointers;
 		}
 
+	public:
+		// Since there can be multiple xrefs, this returns multiple addresses
+		[[nodiscard]] std::vector<SafePointer> find_xrefs(
+			SignatureScanner::XRefTypes types,
+			std::uint8_t instruction_length,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable()) const
+			requires MemoryManager::Viewable<typename MemMgr::RegionT>
+		{
+			if constexpr (detail::ScanKernels<MemMgr>::IS_COMPILED)
+				return detail::ScanKernels<MemMgr>::find_xrefs(*this, types, instruction_length, search_constraints);
+			else
+				return find_xrefs(detail::KernelImplementation{}, types, instruction_length, search_constraints);
+		}
+
 		[[nodiscard]] std::vector<SafePointer> find_xrefs(
 			SignatureScanner::XRefTypes types,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable()) const
@@ -239,6 +421,39 @@ namespace BCRL {
 			return find_xrefs(types, sizeof(RelAddrType), search_constraints);
 		}
 
+		// Pipelined variant, see PipelineOptions
+		[[nodiscard]] std::vector<SafePointer> find_xrefs(
+			SignatureScanner::XRefTypes types,
+			std::uint8_t instruction_length,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+			PipelineOptions options) const
+		{
+			std::vector<SafePointer> new_pointers;
+
+			SignatureScanner::XRefSignature signature{ types, pointer, instruction_length };
+			const auto windows = detail::plan_windows(*memory_manager, search_constraints, options.window_size, sizeof(std::uintptr_t) - 1);
+
+			detail::pipelined_scan(*memory_manager, windows, [&](std::span<const std::byte> bytes, const detail::ScanWindow& window) {
+				signature.all(bytes.begin(), bytes.end(), detail::LambdaInserter([&](decltype(bytes.begin()) match) {
+					const auto offset = static_cast<std::size_t>(std::distance(bytes.begin(), match));
+					if (offset < window.accepted)
+						new_pointers.emplace_back(*memory_manager, window.address + offset);
+				}),
+					window.address);
+			},
+				search_constraints.get_budget());
+
+			return new_pointers;
+		}
+
+		[[nodiscard]] std::vector<SafePointer> find_xrefs(
+			SignatureScanner::XRefTypes types,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+			PipelineOptions options) const
+		{
+			return find_xrefs(types, sizeof(RelAddrType), search_constraints, options);
+		}
+
 		SafePointer& relative_to_absolute()
 		{
 
@@ -281,6 +496,46 @@ namespace BCRL {
 			return add(instruction.value().length);
 		}
 
+		// Call graph
+		template <detail::CallGraph Index>
+		SafePointer& containing_function(const Index& index) // Moves to the start of the surrounding function
+		{
+			std::optional<std::uintptr_t> start = index.containing_function(pointer);
+			if (!start.has_value())
+				return invalidate();
+
+			pointer = start.value();
+			return revalidate();
+		}
+
+		// Functions called by the function which contains this pointer
+		template <detail::CallGraph Index>
+		[[nodiscard]] std::vector<SafePointer> calls(const Index& index) const
+		{
+			std::vector<SafePointer> new_pointers;
+
+			std::optional<std::uintptr_t> function = index.containing_function(pointer);
+			if (!function.has_value())
+				return new_pointers;
+
+			for (const auto& call : index.callees_of(function.value()))
+				new_pointers.emplace_back(*memory_manager, call.callee);
+
+			return new_pointers;
+		}
+
+		// Functions which call this pointer
+		template <detail::CallGraph Index>
+		[[nodiscard]] std::vector<SafePointer> callers(const Index& index) const
+		{
+			std::vector<SafePointer> new_pointers;
+
+			for (const auto& call : index.callers_of(pointer))
+				new_pointers.emplace_back(*memory_manager, call.caller);
+
+			return new_pointers;
+		}
+
 		// Filters
 		[[nodiscard]] bool filter(const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable()) const
 		{
@@ -0,0 +1,121 @@
+#ifndef BCRL_SCANBUDGET_HPP
+#define BCRL_SCANBUDGET_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+namespace BCRL {
+	/**
+	 * Upper bound for the work of scans, which is attached to SearchConstraints with `with_budget`.
+	 * Scans account for their bytes in chunks, once the byte limit or the deadline is reached or a stop is requested, they end early.
+	 * Sessions which ran out of budget finalize to FinalizationError::BUDGET_EXCEEDED.
+	 * A budget may be shared between threads and has to outlive the scans which use it.
+	 */
+	class ScanBudget {
+		std::size_t max_bytes = std::numeric_limits<std::size_t>::max();
+		std::optional<std::chrono::steady_clock::time_point> deadline;
+		std::stop_token stop_token;
+
+		std::atomic<std::size_t> scanned_bytes{ 0 };
+		std::atomic<bool> exceeded{ false };
+
+	public:
+		ScanBudget& with_max_bytes(std::size_t bytes)
+		{
+			max_bytes = bytes;
+			return *this;
+		}
+
+		ScanBudget& with_deadline(std::chrono::steady_clock::time_point time_point)
+		{
+			deadline = time_point;
+			return *this;
+		}
+
+		ScanBudget& with_timeout(std::chrono::steady_clock::duration timeout)
+		{
+			return with_deadline(std::chrono::steady_clock::now() + timeout);
+		}
+
+		ScanBudget& with_stop_token(std::stop_token token)
+		{
+			stop_token = std::move(token);
+			return *this;
+		}
+
+		// Accounts for `bytes` which are about to be scanned, returns false if they exceed the budget
+		bool consume(std::size_t bytes)
+		{
+			if (exceeded.load(std::memory_order_relaxed))
+				return false;
+
+			const std::size_t previous = scanned_bytes.fetch_add(bytes, std::memory_order_relaxed);
+			if (previous + bytes > max_bytes || previous + bytes < previous
+				|| stop_token.stop_requested()
+				|| (deadline && std::chrono::steady_clock::now() >= *deadline)) {
+				exceeded.store(true, std::memory_order_relaxed);
+				return false;
+			}
+			return true;
+		}
+
+		[[nodiscard]] bool is_exceeded() const
+		{
+			return exceeded.load(std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] std::size_t get_scanned_bytes() const
+		{
+			return scanned_bytes.load(std::memory_order_relaxed);
+		}
+
+		// Starts over with the same limits, the deadline stays the same
+		void reset()
+		{
+			scanned_bytes.store(0, std::memory_order_relaxed);
+			exceeded.store(false, std::memory_order_relaxed);
+		}
+	};
+
+	namespace detail {
+		inline constexpr std::size_t BUDGET_CHUNK_SIZE = 256 * 1024;
+
+		/**
+		 * Splits [begin, end) into chunks which are accounted for in the budget, before `scan(chunk_begin, chunk_end, accepted_end)` is called on them.
+		 * Chunks extend `overlap` bytes into the next one, matches are only accepted if they start before `accepted_end`.
+		 * `scan` returns whether to continue, the result is false if the budget ran out.
+		 * Without a budget the range is scanned as a whole.
+		 */
+		template <typename It, typename F>
+		bool for_each_chunk(It begin, It end, std::size_t overlap, ScanBudget* budget, const F& scan)
+		{
+			if (budget == nullptr) {
+				scan(begin, end, end);
+				return true;
+			}
+
+			while (begin != end) {
+				const auto remaining = static_cast<std::size_t>(std::distance(begin, end));
+				const std::size_t accepted = std::min(BUDGET_CHUNK_SIZE, remaining);
+				if (!budget->consume(accepted))
+					return false;
+
+				const It accepted_end = std::next(begin, static_cast<std::ptrdiff_t>(accepted));
+				const It chunk_end = std::next(accepted_end, static_cast<std::ptrdiff_t>(std::min(overlap, remaining - accepted)));
+				if (!scan(begin, chunk_end, accepted_end))
+					return true;
+				begin = accepted_end;
+			}
+			return true;
+		}
+	}
+}
+
+#endif
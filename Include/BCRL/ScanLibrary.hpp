@@ -0,0 +1,63 @@
+#ifndef BCRL_SCANLIBRARY_HPP
+#define BCRL_SCANLIBRARY_HPP
+
+#include "detail/ScanKernel.hpp"
+
+#include "SearchConstraints.hpp"
+
+#include "MemoryManager/LinuxMemoryManager.hpp"
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+#include "SignatureScanner/XRefSignature.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BCRL {
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Reader<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::LengthAware<typename MemMgr::RegionT>
+	class SafePointer;
+
+	template <typename MemMgr>
+	class Session;
+
+	// Memory managers for which BCRLScan contains compiled scan kernels, other memory managers keep instantiating them themselves
+	using LocalLinuxMemoryManager = MemoryManager::LinuxMemoryManager<true, true, true>;
+
+	namespace detail {
+		// Defined in Source/ScanLibrary.cpp, in one version per instruction set extension
+		template <>
+		struct ScanKernels<LocalLinuxMemoryManager> {
+			static constexpr bool IS_COMPILED = true;
+
+			using SafePointerT = SafePointer<LocalLinuxMemoryManager>;
+			using SearchConstraintsT = SearchConstraints<LocalLinuxMemoryManager::RegionT>;
+
+			static SafePointerT& prev_signature_occurrence(
+				SafePointerT& safe_pointer,
+				const SignatureScanner::PatternSignature& signature,
+				std::size_t max_distance,
+				const SearchConstraintsT& search_constraints);
+
+			static SafePointerT& next_signature_occurrence(
+				SafePointerT& safe_pointer,
+				const SignatureScanner::PatternSignature& signature,
+				const SearchConstraintsT& search_constraints);
+
+			static std::vector<SafePointerT> find_xrefs(
+				const SafePointerT& safe_pointer,
+				SignatureScanner::XRefTypes types,
+				std::uint8_t instruction_length,
+				const SearchConstraintsT& search_constraints);
+
+			static Session<LocalLinuxMemoryManager> signature(
+				const LocalLinuxMemoryManager& memory_manager,
+				const SignatureScanner::PatternSignature& signature,
+				const SearchConstraintsT& search_constraints);
+		};
+	}
+}
+
+#endif
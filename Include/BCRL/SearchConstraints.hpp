@@ -4,9 +4,11 @@
 #include "detail/ConditionalField.hpp"
 
 #include "FlagSpecification.hpp"
+#include "ScanBudget.hpp"
 
 #include "MemoryManager/MemoryManager.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -32,6 +34,7 @@ namespace BCRL {
 			address_range;
 		[[no_unique_address]] detail::ConditionalField<MemoryManager::FlagAware<Region>, FlagSpecification> flags;
 		[[no_unique_address]] detail::ConditionalField<MemoryManager::SharedAware<Region>, std::optional<bool>> shared;
+		ScanBudget* budget = nullptr;
 
 	public:
 		SearchConstraints()
@@ -170,7 +173,24 @@ namespace BCRL {
 			return *this;
 		}
 
+		SearchConstraints& with_budget(ScanBudget& scan_budget) // The budget has to outlive all scans using these constraints
+		{
+			budget = &scan_budget;
+
+			return *this;
+		}
+
 		// Past-initialization usage
+		[[nodiscard]] ScanBudget* get_budget() const
+		{
+			return budget;
+		}
+
+		[[nodiscard]] bool is_budget_exceeded() const
+		{
+			return budget != nullptr && budget->is_exceeded();
+		}
+
 		[[nodiscard]] bool allows_address(std::uintptr_t address) const
 			requires MemoryManager::AddressAware<Region> && MemoryManager::LengthAware<Region>
 		{
@@ -210,6 +230,14 @@ namespace BCRL {
 			if (pointer_end > address_range.second)
 				std::advance(end, address_range.second - pointer_end);
 		}
+
+		// Same as above, but for plain addresses
+		void clamp_to_address_range(std::uintptr_t& begin, std::uintptr_t& end) const
+			requires MemoryManager::AddressAware<Region> && MemoryManager::LengthAware<Region>
+		{
+			begin = std::max(begin, address_range.first);
+			end = std::min(end, address_range.second);
+		}
 	};
 
 	template <typename MemMgr>
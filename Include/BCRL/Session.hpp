@@ -1,8 +1,13 @@
 #ifndef BCRL_HPP
 #define BCRL_HPP
 
+#include "detail/BatchRead.hpp"
 #include "detail/LambdaInserter.hpp"
+#include "detail/MaskedPattern.hpp"
+#include "detail/ScanKernel.hpp"
 
+#include "FixedSignature.hpp"
+#include "PipelinedScan.hpp"
 #include "SafePointer.hpp"
 #include "SearchConstraints.hpp"
 
@@ -13,13 +18,19 @@
 
 #include "LengthDisassembler/LengthDisassembler.hpp"
 
+#include <algorithm>
 #include <alloca.h>
+#include <array>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <initializer_list>
+#include <limits>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -30,14 +41,96 @@ namespace BCRL {
 	enum class FinalizationError : std::uint8_t {
 		NO_POINTERS_LEFT,
 		TOO_MANY_POINTERS_LEFT,
+		BUDGET_EXCEEDED, // A scan ended early because its ScanBudget ran out, so the result may be incomplete
 	};
 
+	namespace detail {
+		template <typename T>
+		struct UnwrapOptional {
+			using Type = T;
+			static constexpr bool IS_OPTIONAL = false;
+		};
+
+		template <typename T>
+		struct UnwrapOptional<std::optional<T>> {
+			using Type = T;
+			static constexpr bool IS_OPTIONAL = true;
+		};
+
+		// Satisfied by JumpTableCache, JumpTable.hpp has to be included to use switch_cases
+		template <typename Cache>
+		concept JumpTableSource = requires(Cache& cache, std::uintptr_t address) {
+			{ cache.find(address)->targets } -> std::convertible_to<std::vector<std::uintptr_t>>;
+		};
+	}
+
 	template <typename MemMgr>
 	class Session {
 		using InnerSafePointer = SafePointer<MemMgr>;
 
 		const MemMgr* memory_manager;
 		std::vector<InnerSafePointer> pointers;
+		bool sorted = false; // Pointers are kept ascending and unique
+		bool budget_exceeded = false;
+
+		Session& note_budget(const SearchConstraints<typename MemMgr::RegionT>& search_constraints)
+		{
+			if (search_constraints.is_budget_exceeded())
+				budget_exceeded = true;
+			return *this;
+		}
+
+		void sort_and_deduplicate()
+		{
+			if (!std::ranges::is_sorted(pointers))
+				std::ranges::sort(pointers);
+			auto [first, last] = std::ranges::unique(pointers);
+			pointers.erase(first, last);
+		}
+
+		// Pairs of key and pointer, ascending by key, pointers whose key is an empty optional are appended to `keyless` instead, if given
+		template <typename F>
+		static auto make_keyed(const std::vector<InnerSafePointer>& pointers, const F& key, std::vector<InnerSafePointer>* keyless = nullptr)
+		{
+			using Key = detail::UnwrapOptional<std::remove_cvref_t<std::invoke_result_t<const F&, const InnerSafePointer&>>>;
+
+			std::vector<std::pair<typename Key::Type, InnerSafePointer>> keyed;
+			keyed.reserve(pointers.size());
+			for (const InnerSafePointer& safe_pointer : pointers) {
+				if constexpr (Key::IS_OPTIONAL) {
+					if (auto value = key(safe_pointer))
+						keyed.emplace_back(std::move(*value), safe_pointer);
+					else if (keyless)
+						keyless->push_back(safe_pointer);
+				} else
+					keyed.emplace_back(key(safe_pointer), safe_pointer);
+			}
+
+			// Sessions in sorted mode are ascending by address already, which is the order of the default key
+			auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+			if (!std::ranges::is_sorted(keyed, by_key))
+				std::ranges::sort(keyed, by_key);
+			return keyed;
+		}
+
+		// Pointers of `from` whose key does (or doesn't) occur in `in`, found by a linear merge
+		template <typename Keyed>
+		static void merge_keys(const Keyed& from, const Keyed& in, bool keep_found, std::vector<InnerSafePointer>& result)
+		{
+			auto it = in.begin();
+			for (const auto& [key, safe_pointer] : from) {
+				while (it != in.end() && it->first < key)
+					++it;
+				const bool found = it != in.end() && !(key < it->first);
+				if (found == keep_found)
+					result.push_back(safe_pointer);
+			}
+		}
+
+		static std::uintptr_t address_key(const InnerSafePointer& safe_pointer)
+		{
+			return safe_pointer.get_pointer();
+		}
 
 	public:
 		constexpr Session(const MemMgr& memory_manager, std::vector<InnerSafePointer>&& pointers)
@@ -86,9 +179,22 @@ namespace BCRL {
 			const SignatureScanner::PatternSignature& signature,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 		{
-			return for_each([&signature, &search_constraints](InnerSafePointer& safe_pointer) {
+			for_each([&signature, &search_constraints](InnerSafePointer& safe_pointer) {
 				safe_pointer.prev_signature_occurrence(signature, search_constraints);
 			});
+			return note_budget(search_constraints);
+		}
+
+		// Prev occurrence of signature, at most `max_distance` bytes before each pointer
+		Session& prev_signature_occurrence(
+			const SignatureScanner::PatternSignature& signature,
+			std::size_t max_distance,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+		{
+			for_each([&signature, max_distance, &search_constraints](InnerSafePointer& safe_pointer) {
+				safe_pointer.prev_signature_occurrence(signature, max_distance, search_constraints);
+			});
+			return note_budget(search_constraints);
 		}
 
 		// Next occurrence of signature
@@ -96,9 +202,20 @@ namespace BCRL {
 			const SignatureScanner::PatternSignature& signature,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 		{
-			return for_each([&signature, &search_constraints](InnerSafePointer& safe_pointer) {
+			for_each([&signature, &search_constraints](InnerSafePointer& safe_pointer) {
 				safe_pointer.next_signature_occurrence(signature, search_constraints);
 			});
+			return note_budget(search_constraints);
+		}
+
+		Session& next_signature_occurrence(
+			FixedSignature auto signature,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+		{
+			for_each([signature, &search_constraints](InnerSafePointer& safe_pointer) {
+				safe_pointer.next_signature_occurrence(signature, search_constraints);
+			});
+			return note_budget(search_constraints);
 		}
 
 		// Filters
@@ -109,24 +226,163 @@ namespace BCRL {
 			});
 		}
 
+		// Same as filtering with `does_match`, but the bytes of all pointers are read in batches and several candidates are compared per SIMD step
+		Session& filter_matching(const SignatureScanner::PatternSignature& signature)
+		{
+			const detail::MaskedPattern pattern{ signature };
+
+			std::vector<std::uintptr_t> addresses;
+			addresses.reserve(pointers.size());
+			for (const InnerSafePointer& safe_pointer : pointers)
+				addresses.push_back(safe_pointer.get_pointer());
+			std::ranges::sort(addresses);
+			auto [first, last] = std::ranges::unique(addresses);
+			addresses.erase(first, last);
+
+			std::vector<bool> matching(addresses.size());
+
+			// Candidates of the current batch, which are verified together
+			std::array<const std::byte*, detail::MaskedPattern::VECTOR_WIDTH> group{};
+			std::array<std::size_t, detail::MaskedPattern::VECTOR_WIDTH> group_indices{};
+			std::size_t group_size = 0;
+			auto verify_group = [&] {
+				const std::uint32_t matches = pattern.matches_many(std::span{ group }.first(group_size));
+				for (std::size_t i = 0; i < group_size; i++)
+					matching[group_indices[i]] = (matches >> i) & 1;
+				group_size = 0;
+			};
+
+			auto add_candidate = [&](std::size_t index, const std::byte* bytes) {
+				if (bytes == nullptr) {
+					matching[index] = InnerSafePointer{ *memory_manager, addresses[index] }.does_match(signature); // Spans multiple regions
+					return;
+				}
+
+				group[group_size] = bytes;
+				group_indices[group_size] = index;
+				if (++group_size == group.size())
+					verify_group();
+			};
+			// The bytes of the batch are about to be overwritten
+			auto end_batch = [&] {
+				if (group_size > 0)
+					verify_group();
+			};
+
+			detail::batch_read(*memory_manager, addresses, pattern.size(), 0, add_candidate, end_batch);
+
+			return filter([&addresses, &matching](const InnerSafePointer& safe_pointer) {
+				return matching[std::ranges::lower_bound(addresses, safe_pointer.get_pointer()) - addresses.begin()];
+			});
+		}
+
+		// Re-reads a value of type T at every pointer in batches and keeps the pointers whose value satisfies the predicate
+		template <typename T, typename Predicate>
+			requires std::is_trivially_copyable_v<T> && std::predicate<Predicate, const T&>
+		Session& filter_values(const Predicate& predicate)
+		{
+			std::vector<std::uintptr_t> addresses;
+			addresses.reserve(pointers.size());
+			for (const InnerSafePointer& safe_pointer : pointers)
+				addresses.push_back(safe_pointer.get_pointer());
+			std::ranges::sort(addresses);
+			auto [first, last] = std::ranges::unique(addresses);
+			addresses.erase(first, last);
+
+			std::vector<bool> matching(addresses.size());
+			detail::batch_read(*memory_manager, addresses, sizeof(T), 0, [&](std::size_t index, const std::byte* bytes) {
+				std::optional<T> value;
+				if (bytes != nullptr) {
+					value.emplace();
+					std::memcpy(&value.value(), bytes, sizeof(T));
+				} else
+					value = InnerSafePointer{ *memory_manager, addresses[index] }.template read<T>(); // Spans multiple regions
+				matching[index] = value.has_value() && predicate(value.value());
+			});
+
+			return filter([&addresses, &matching](const InnerSafePointer& safe_pointer) {
+				return matching[std::ranges::lower_bound(addresses, safe_pointer.get_pointer()) - addresses.begin()];
+			});
+		}
+
 		// X86
 		Session& find_xrefs(
 			SignatureScanner::XRefTypes types,
 			std::uint8_t instruction_length,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 		{
-			return flat_map([types, instruction_length, &search_constraints](const InnerSafePointer& safe_pointer) {
+			flat_map([types, instruction_length, &search_constraints](const InnerSafePointer& safe_pointer) {
 				return safe_pointer.find_xrefs(types, instruction_length, search_constraints);
 			});
+			return note_budget(search_constraints);
 		}
 
 		Session& find_xrefs(
 			SignatureScanner::XRefTypes types,
 			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 		{
-			return flat_map([types, &search_constraints](const InnerSafePointer& safe_pointer) {
+			flat_map([types, &search_constraints](const InnerSafePointer& safe_pointer) {
 				return safe_pointer.find_xrefs(types, search_constraints);
 			});
+			return note_budget(search_constraints);
+		}
+
+		Session& find_xrefs(
+			SignatureScanner::XRefTypes types,
+			std::uint8_t instruction_length,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+			PipelineOptions options)
+		{
+			flat_map([types, instruction_length, &search_constraints, options](const InnerSafePointer& safe_pointer) {
+				return safe_pointer.find_xrefs(types, instruction_length, search_constraints, options);
+			});
+			return note_budget(search_constraints);
+		}
+
+		Session& find_xrefs(
+			SignatureScanner::XRefTypes types,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+			PipelineOptions options)
+		{
+			flat_map([types, &search_constraints, options](const InnerSafePointer& safe_pointer) {
+				return safe_pointer.find_xrefs(types, search_constraints, options);
+			});
+			return note_budget(search_constraints);
+		}
+
+		// Replaces every pointer with the `count` values of an array at it, which are `stride` bytes apart, e.g. the slots of a vtable
+		template <typename T = std::uintptr_t>
+			requires std::is_trivially_copyable_v<T> && (std::integral<T> || std::is_pointer_v<T>)
+		Session& expand_array(std::size_t count, std::size_t stride = sizeof(T))
+		{
+			std::vector<std::byte> bytes;
+			return flat_map([count, stride, &bytes](const InnerSafePointer& safe_pointer) {
+				std::vector<InnerSafePointer> elements;
+				// Without a stride, the element count isn't bounded by the memory behind the pointer
+				if (count == 0 || (stride == 0 && count > 1))
+					return elements;
+
+				// The whole array is read at once, the size in bytes has to be representable, validate before allocating for it
+				if (stride != 0 && count - 1 > (std::numeric_limits<std::size_t>::max() - sizeof(T)) / stride)
+					return elements;
+				const std::size_t size = (count - 1) * stride + sizeof(T);
+				if (!safe_pointer.is_valid(size))
+					return elements;
+
+				bytes.resize(size);
+				safe_pointer.get_memory_manager().read(safe_pointer.get_pointer(), bytes.data(), size);
+
+				elements.reserve(count);
+				for (std::size_t i = 0; i < count; i++) {
+					T value;
+					std::memcpy(&value, bytes.data() + i * stride, sizeof(T));
+					if constexpr (std::is_pointer_v<T>)
+						elements.emplace_back(safe_pointer.get_memory_manager(), reinterpret_cast<std::uintptr_t>(value));
+					else
+						elements.emplace_back(safe_pointer.get_memory_manager(), static_cast<std::uintptr_t>(value));
+				}
+				return elements;
+			});
 		}
 
 		Session& relative_to_absolute()
@@ -145,6 +401,51 @@ namespace BCRL {
 			});
 		}
 
+		// Call graph
+		template <detail::CallGraph Index>
+		Session& containing_function(const Index& index)
+		{
+			return for_each([&index](InnerSafePointer& safe_pointer) {
+				safe_pointer.containing_function(index);
+			});
+		}
+
+		template <detail::CallGraph Index>
+		Session& calls(const Index& index)
+		{
+			return flat_map([&index](const InnerSafePointer& safe_pointer) {
+				return safe_pointer.calls(index);
+			});
+		}
+
+		template <detail::CallGraph Index>
+		Session& callers(const Index& index)
+		{
+			return flat_map([&index](const InnerSafePointer& safe_pointer) {
+				return safe_pointer.callers(index);
+			});
+		}
+
+		// Replaces every pointer to the dispatch code of a switch statement with the targets of its cases, see JumpTableCache
+		template <detail::JumpTableSource Cache>
+		Session& switch_cases(Cache& cache)
+		{
+			return flat_map([&cache](const InnerSafePointer& safe_pointer) {
+				std::vector<InnerSafePointer> targets;
+				if (auto table = cache.find(safe_pointer.get_pointer())) {
+					// Cases which share their code, such as the default case, would otherwise appear multiple times
+					std::ranges::sort(table->targets);
+					auto [first, last] = std::ranges::unique(table->targets);
+					table->targets.erase(first, last);
+
+					targets.reserve(table->targets.size());
+					for (const std::uintptr_t target : table->targets)
+						targets.emplace_back(safe_pointer.get_memory_manager(), target);
+				}
+				return targets;
+			});
+		}
+
 		// Advanced Flow
 		template <typename F>
 			requires std::invocable<F, InnerSafePointer&>
@@ -155,6 +456,8 @@ namespace BCRL {
 				body(safe_pointer);
 				return !safe_pointer.is_valid();
 			});
+			if (sorted)
+				sort_and_deduplicate();
 			return *this;
 		}
 		template <typename F>
@@ -199,8 +502,72 @@ namespace BCRL {
 				}
 			}
 			pointers = std::move(new_safe_pointers);
+			if (sorted)
+				sort_and_deduplicate();
+			return *this;
+		}
+
+		// Sorted mode: Sorts and deduplicates the pointers, and keeps them that way after every following operation
+		Session& keep_sorted()
+		{
+			sorted = true;
+			sort_and_deduplicate();
+			return *this;
+		}
+
+		/**
+		 * Set operations, the results are ascending and unique.
+		 * With a key function, pointers are compared by their key instead, e.g. the function or region which contains them.
+		 * A key function may return an std::optional, pointers without a key never match anything:
+		 * `intersect` drops them, `subtract` keeps them and `unite` adds those of the other session.
+		 * Both sides are merged linearly, which only requires sorting if they aren't in sorted mode or a key is used.
+		 */
+		template <typename F>
+			requires std::invocable<const F&, const InnerSafePointer&>
+		Session& intersect(const Session& other, const F& key) // Keeps the pointers whose key occurs in the other session
+		{
+			std::vector<InnerSafePointer> result;
+			merge_keys(make_keyed(pointers, key), make_keyed(other.pointers, key), true, result);
+			pointers = std::move(result);
+			sort_and_deduplicate();
+			return *this;
+		}
+		Session& intersect(const Session& other)
+		{
+			return intersect(other, address_key);
+		}
+
+		template <typename F>
+			requires std::invocable<const F&, const InnerSafePointer&>
+		Session& subtract(const Session& other, const F& key) // Keeps the pointers whose key doesn't occur in the other session
+		{
+			std::vector<InnerSafePointer> result;
+			const auto keyed = make_keyed(pointers, key, &result);
+			merge_keys(keyed, make_keyed(other.pointers, key), false, result);
+			pointers = std::move(result);
+			sort_and_deduplicate();
 			return *this;
 		}
+		Session& subtract(const Session& other)
+		{
+			return subtract(other, address_key);
+		}
+
+		template <typename F>
+			requires std::invocable<const F&, const InnerSafePointer&>
+		Session& unite(const Session& other, const F& key) // Adds the pointers of the other session whose key doesn't occur in this one
+		{
+			std::vector<InnerSafePointer> result = pointers;
+			const auto keyed = make_keyed(other.pointers, key, &result);
+			merge_keys(keyed, make_keyed(pointers, key), false, result);
+			pointers = std::move(result);
+			sort_and_deduplicate();
+			return *this;
+		}
+		Session& unite(const Session& other)
+		{
+			return unite(other, address_key);
+		}
 
 		[[nodiscard]] constexpr Session clone() const
 		{
@@ -212,6 +579,18 @@ namespace BCRL {
 			return *memory_manager;
 		}
 
+		// Used by openers whose scan ran out of budget, finalization fails with BUDGET_EXCEEDED from now on
+		Session& mark_budget_exceeded()
+		{
+			budget_exceeded = true;
+			return *this;
+		}
+
+		[[nodiscard]] bool is_budget_exceeded() const
+		{
+			return budget_exceeded;
+		}
+
 		// Finalizing
 		[[nodiscard]] const std::vector<InnerSafePointer>& peek() const // Allows to peek at all remaining pointers
 		{
@@ -220,6 +599,9 @@ namespace BCRL {
 
 		[[nodiscard]] std::expected<std::uintptr_t, FinalizationError> finalize() const // Returns a std::expected based on if there is a clear result
 		{
+			if (budget_exceeded)
+				return std::unexpected(FinalizationError::BUDGET_EXCEEDED);
+
 			if (pointers.size() == 1)
 				return pointers.begin()->get_pointer();
 
@@ -244,12 +626,15 @@ namespace BCRL {
 			auto result = finalize<T>();
 
 			if (!result.has_value())
-				throw std::runtime_error{ [&none, &too_many, error = result.error()]() {
+				throw std::runtime_error{ [this, &none, &too_many, error = result.error()]() {
 					switch (error) {
 					case FinalizationError::NO_POINTERS_LEFT:
 						return none;
 					case FinalizationError::TOO_MANY_POINTERS_LEFT:
 						return too_many;
+					case FinalizationError::BUDGET_EXCEEDED:
+						// Whatever is left may be incomplete, so even a single pointer is not a clear result
+						return (pointers.empty() ? none : too_many) + " (scan budget exceeded)";
 					}
 					std::unreachable();
 				}() };
@@ -297,12 +682,95 @@ namespace BCRL {
 		return pointer_list(memory_manager, bases);
 	}
 
+	namespace detail {
+		template <typename MemMgr>
+			requires MemoryManager::Viewable<typename MemMgr::RegionT>
+		[[nodiscard]] inline Session<MemMgr> signature_scan(
+			const MemMgr& memory_manager,
+			const SignatureScanner::PatternSignature& signature,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints)
+		{
+			std::vector<std::uintptr_t> pointers{};
+
+			for (const auto& region : memory_manager.get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+
+				auto view = region.view();
+
+				auto begin = view.cbegin();
+				auto end = view.cend();
+
+				search_constraints.clamp_to_address_range(region, view.cbegin(), begin, end);
+
+				const std::size_t overlap = signature.get_elements().empty() ? 0 : signature.get_elements().size() - 1;
+				const bool within_budget = detail::for_each_chunk(begin, end, overlap, search_constraints.get_budget(), [&](auto chunk_begin, auto chunk_end, auto accepted_end) {
+					const auto accepted = std::distance(chunk_begin, accepted_end);
+					auto inserter = detail::LambdaInserter([&](decltype(begin) p) {
+						if (std::distance(chunk_begin, p) < accepted)
+							pointers.push_back(region.get_address() + std::distance(view.cbegin(), p));
+					});
+					if constexpr (std::same_as<decltype(signature), const SignatureScanner::XRefSignature&>)
+						signature.all(chunk_begin, chunk_end, inserter, region.get_address() + std::distance(view.cbegin(), chunk_begin));
+					else
+						signature.all(chunk_begin, chunk_end, inserter);
+					return true;
+				});
+				if (!within_budget)
+					return Session<MemMgr>{ memory_manager, pointers }.mark_budget_exceeded();
+			}
+
+			return { memory_manager, pointers };
+		}
+	}
+
 	template <typename MemMgr>
 		requires MemoryManager::Viewable<typename MemMgr::RegionT>
 	[[nodiscard]] inline Session<MemMgr> signature(
 		const MemMgr& memory_manager,
 		const SignatureScanner::PatternSignature& signature,
 		const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
+	{
+		if constexpr (detail::ScanKernels<MemMgr>::IS_COMPILED)
+			return detail::ScanKernels<MemMgr>::signature(memory_manager, signature, search_constraints);
+		else
+			return detail::signature_scan(memory_manager, signature, search_constraints);
+	}
+
+	// Pipelined variant, see PipelineOptions
+	template <typename MemMgr>
+	[[nodiscard]] inline Session<MemMgr> signature(
+		const MemMgr& memory_manager,
+		const SignatureScanner::PatternSignature& signature,
+		const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+		PipelineOptions options)
+	{
+		std::vector<std::uintptr_t> pointers{};
+
+		const std::size_t overlap = signature.get_elements().empty() ? 0 : signature.get_elements().size() - 1;
+		const auto windows = detail::plan_windows(memory_manager, search_constraints, options.window_size, overlap);
+
+		detail::pipelined_scan(memory_manager, windows, [&](std::span<const std::byte> bytes, const detail::ScanWindow& window) {
+			signature.all(bytes.begin(), bytes.end(), detail::LambdaInserter([&](decltype(bytes.begin()) p) {
+				const auto offset = static_cast<std::size_t>(std::distance(bytes.begin(), p));
+				if (offset < window.accepted)
+					pointers.push_back(window.address + offset);
+			}));
+		},
+			search_constraints.get_budget());
+
+		Session<MemMgr> session{ memory_manager, pointers };
+		if (search_constraints.is_budget_exceeded())
+			session.mark_budget_exceeded();
+		return session;
+	}
+
+	template <typename MemMgr>
+		requires MemoryManager::Viewable<typename MemMgr::RegionT>
+	[[nodiscard]] inline Session<MemMgr> signature(
+		const MemMgr& memory_manager,
+		FixedSignature auto signature,
+		const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().thats_readable())
 	{
 		std::vector<std::uintptr_t> pointers{};
 
@@ -310,23 +778,27 @@ namespace BCRL {
 			if (!search_constraints.allows_region(region))
 				continue;
 
-			auto view = region.view();
+			detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ region };
+			std::span<const std::byte> bytes = region_bytes.get();
 
-			auto begin = view.cbegin();
-			auto end = view.cend();
+			auto begin = bytes.begin();
+			auto end = bytes.end();
 
-			search_constraints.clamp_to_address_range(region, view.cbegin(), begin, end);
+			search_constraints.clamp_to_address_range(region, bytes.begin(), begin, end);
 
-			if constexpr (std::same_as<decltype(signature), const SignatureScanner::XRefSignature&>) {
-				signature.all(begin, end, detail::LambdaInserter([&](decltype(begin) p) {
-					pointers.push_back(region.get_address() + std::distance(view.cbegin(), p));
-				}),
-					region.get_address() + std::distance(view.cbegin(), begin));
-			} else {
-				signature.all(begin, end, detail::LambdaInserter([&](decltype(begin) p) {
-					pointers.push_back(region.get_address() + std::distance(view.cbegin(), p));
-				}));
-			}
+			if (begin >= end)
+				continue;
+
+			const bool within_budget = detail::for_each_chunk(begin, end, decltype(signature)::SIZE - 1, search_constraints.get_budget(), [&](auto chunk_begin, auto chunk_end, auto accepted_end) {
+				std::span<const std::byte> haystack{ chunk_begin, chunk_end };
+				const auto accepted = static_cast<std::size_t>(std::distance(chunk_begin, accepted_end));
+				const std::uintptr_t base = region.get_address() + std::distance(bytes.begin(), chunk_begin);
+				for (std::size_t hit = signature.next(haystack); hit < accepted; hit = signature.next(haystack, hit + 1))
+					pointers.push_back(base + hit);
+				return true;
+			});
+			if (!within_budget)
+				return Session<MemMgr>{ memory_manager, pointers }.mark_budget_exceeded();
 		}
 
 		return { memory_manager, pointers };
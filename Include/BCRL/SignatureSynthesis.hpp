@@ -0,0 +1,154 @@
+#ifndef BCRL_SIGNATURESYNTHESIS_HPP
+#define BCRL_SIGNATURESYNTHESIS_HPP
+
+#include "detail/ByteFrequency.hpp"
+#include "detail/PatternText.hpp"
+#include "detail/X86.hpp"
+
+#include "SafePointer.hpp"
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+
+#include "LengthDisassembler/LengthDisassembler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace BCRL {
+	struct SignatureSynthesisOptions {
+		std::size_t max_length = 64;
+		std::size_t extra_candidates = 2; // Longer candidates which are measured after the first unique one, for comparison
+	};
+
+	struct SignatureCandidate {
+		SignatureScanner::PatternSignature signature;
+		std::string pattern; // Text form, as accepted by `for_array_of_bytes`
+		std::size_t instructions;
+		std::size_t wildcards;
+		std::size_t anchor_commonness; // `byte_commonness` of the rarest byte, lower is better
+		std::size_t matches;
+		std::chrono::nanoseconds scan_time;
+
+		[[nodiscard]] bool is_unique() const
+		{
+			return matches == 1;
+		}
+	};
+
+	/**
+	 * Generates signatures for the code at `target`, which start at `target` and cover a growing number of instructions.
+	 * Relative call/jump targets and RIP-relative displacements are wildcarded, since they change whenever the code or data moves.
+	 *
+	 * Every candidate is scanned for within the search constraints (usually the module of the target, e.g. `with_name`)
+	 * and the scan is timed. The result is sorted from best to worst:
+	 * Unique candidates first, ordered by length, rarest anchor byte and number of wildcards.
+	 * Returns an empty vector if no instruction could be decoded at the target.
+	 * Throws a std::invalid_argument if the target is outside of the search constraints, since no candidate could find it.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT>
+	[[nodiscard]] std::vector<SignatureCandidate> synthesize_signatures(
+		const MemMgr& memory_manager,
+		std::uintptr_t target,
+		const SearchConstraints<typename MemMgr::RegionT>& search_constraints,
+		const SignatureSynthesisOptions& options = {})
+	{
+		auto* target_region = memory_manager.get_layout().find_region(target);
+		if (!target_region || !search_constraints.allows_region(*target_region) || !search_constraints.allows_address(target))
+			throw std::invalid_argument{ "Target is outside of the search constraints" };
+
+		std::vector<detail::PatternElement> elements;
+		std::vector<std::size_t> boundaries; // Pattern lengths after every instruction
+
+		SafePointer<MemMgr> instruction{ memory_manager, target };
+		while (elements.size() < options.max_length) {
+			const std::uintptr_t begin = instruction.get_pointer();
+			if (!instruction.next_instruction().is_valid())
+				break;
+
+			const std::size_t length = instruction.get_pointer() - begin;
+			if (elements.size() + length > options.max_length)
+				break;
+
+			std::vector<std::byte> bytes(length);
+			if (!SafePointer{ memory_manager, begin }.read(bytes.data(), bytes.size()))
+				break;
+
+			const std::optional<detail::x86::Operand> operand = detail::x86::relocatable_operand(bytes);
+			for (std::size_t i = 0; i < length; i++) {
+				if (operand && i >= operand->offset && i < operand->offset + operand->size)
+					elements.emplace_back();
+				else
+					elements.emplace_back(bytes[i]);
+			}
+			boundaries.push_back(elements.size());
+		}
+
+		std::vector<SignatureCandidate> candidates;
+		std::size_t unique_candidates = 0;
+
+		for (std::size_t i = 0; i < boundaries.size() && unique_candidates <= options.extra_candidates; i++) {
+			// Trailing wildcards don't make the pattern more specific
+			std::size_t length = boundaries[i];
+			while (length > 0 && !elements[length - 1].has_value())
+				length--;
+			if (length == 0 || (!candidates.empty() && candidates.back().signature.get_elements().size() == length))
+				continue;
+
+			SignatureScanner::PatternSignature signature{ std::vector<detail::PatternElement>{ elements.begin(), elements.begin() + static_cast<std::ptrdiff_t>(length) } };
+
+			std::size_t wildcards = 0;
+			std::size_t anchor_commonness = SIZE_MAX;
+			for (const detail::PatternElement& element : signature.get_elements()) {
+				if (element.has_value())
+					anchor_commonness = std::min(anchor_commonness, detail::byte_commonness(element.value()));
+				else
+					wildcards++;
+			}
+
+			const auto start = std::chrono::steady_clock::now();
+			const Session<MemMgr> session = BCRL::signature(memory_manager, signature, search_constraints);
+			const auto scan_time = std::chrono::steady_clock::now() - start;
+
+			const bool found_target = std::ranges::any_of(session.peek(), [target](const auto& safe_pointer) {
+				return safe_pointer.get_pointer() == target;
+			});
+			if (!found_target)
+				continue; // The scan was cut short by the budget of the search constraints
+
+			SignatureCandidate candidate{
+				std::move(signature),
+				{},
+				i + 1,
+				wildcards,
+				anchor_commonness,
+				session.peek().size(),
+				std::chrono::duration_cast<std::chrono::nanoseconds>(scan_time),
+			};
+			candidate.pattern = detail::pattern_to_string(candidate.signature);
+
+			if (candidate.is_unique())
+				unique_candidates++;
+			candidates.emplace_back(std::move(candidate));
+		}
+
+		std::ranges::stable_sort(candidates, {}, [](const SignatureCandidate& candidate) {
+			return std::tuple{ !candidate.is_unique(), candidate.signature.get_elements().size(), candidate.anchor_commonness, candidate.wildcards };
+		});
+		return candidates;
+	}
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef BCRL_STRINGINDEX_HPP
+#define BCRL_STRINGINDEX_HPP
+
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BCRL {
+	/**
+	 * Maps the contents of every NUL-terminated printable string in a set of regions to the addresses it is stored at.
+	 * Building the index costs one pass over the regions, afterwards every lookup is a hash table access.
+	 *
+	 * Unlike a `PatternSignature::for_literal_string` scan, only whole strings are indexed,
+	 * meaning that a lookup won't find a string which is merely the tail of a longer one.
+	 * Strings shorter than `min_length` aren't indexed, since most short printable runs in data are not strings, lookups for them throw.
+	 */
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::Viewable<typename MemMgr::RegionT>
+	class StringIndex {
+		struct StringHash {
+			// NOLINTNEXTLINE(readability-identifier-naming)
+			using is_transparent = void;
+
+			std::size_t operator()(std::string_view string) const
+			{
+				return std::hash<std::string_view>{}(string);
+			}
+		};
+
+		const MemMgr* memory_manager;
+		std::size_t min_length;
+		std::unordered_map<std::string, std::vector<std::uintptr_t>, StringHash, std::equal_to<>> strings;
+
+		static constexpr bool is_printable(std::byte b)
+		{
+			const auto c = static_cast<unsigned char>(b);
+			return (c >= 0x20 && c < 0x7F) || c == '\t' || c == '\n' || c == '\r';
+		}
+
+	public:
+		explicit StringIndex(
+			const MemMgr& memory_manager,
+			const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().with_flags("r--"),
+			std::size_t min_length = 4)
+			: memory_manager(&memory_manager)
+			, min_length(min_length)
+		{
+			std::string current;
+			for (const auto& region : memory_manager.get_layout()) {
+				if (!search_constraints.allows_region(region))
+					continue;
+
+				auto view = region.view();
+
+				auto begin = view.cbegin();
+				auto end = view.cend();
+
+				search_constraints.clamp_to_address_range(region, view.cbegin(), begin, end);
+
+				std::uintptr_t address = region.get_address() + std::distance(view.cbegin(), begin);
+				std::uintptr_t string_begin = address;
+				current.clear();
+
+				for (auto it = begin; it != end; ++it, ++address) {
+					const std::byte b = *it;
+					if (is_printable(b)) {
+						if (current.empty())
+							string_begin = address;
+						current.push_back(static_cast<char>(b));
+						continue;
+					}
+
+					if (b == std::byte{ 0 } && current.size() >= min_length)
+						strings[current].push_back(string_begin);
+
+					current.clear();
+				}
+			}
+		}
+
+		// Throws a std::invalid_argument if the string is shorter than the minimum length, since it can't be in the index
+		[[nodiscard]] std::span<const std::uintptr_t> find(std::string_view string) const
+		{
+			if (string.size() < min_length)
+				throw std::invalid_argument{ "String is shorter than the minimum length of the index" };
+
+			auto it = strings.find(string);
+			if (it == strings.end())
+				return {};
+			return it->second;
+		}
+
+		[[nodiscard]] std::size_t get_min_length() const
+		{
+			return min_length;
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return strings.size();
+		}
+
+		[[nodiscard]] constexpr const MemMgr& get_memory_manager() const
+		{
+			return *memory_manager;
+		}
+	};
+
+	// Opener which replaces `signature(memory_manager, PatternSignature::for_literal_string<...>())` with an index lookup
+	template <typename MemMgr>
+	[[nodiscard]] inline Session<MemMgr> strings(const StringIndex<MemMgr>& index, std::string_view string)
+	{
+		return pointer_list(index.get_memory_manager(), index.find(string));
+	}
+}
+
+#endif
@@ -0,0 +1,334 @@
+#ifndef BCRL_VALUESCANNER_HPP
+#define BCRL_VALUESCANNER_HPP
+
+#include "detail/BatchRead.hpp"
+#include "detail/RegionBytes.hpp"
+
+#include "SearchConstraints.hpp"
+#include "Session.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace BCRL {
+	// Predicates for value scans, these have SIMD implementations for scalar types
+	template <typename T>
+	struct ValueEquals {
+		T value;
+
+		constexpr bool operator()(const T& other) const
+		{
+			return other == value;
+		}
+	};
+
+	template <typename T>
+	struct ValueInRange {
+		T lowest;
+		T highest;
+
+		constexpr bool operator()(const T& other) const
+		{
+			return other >= lowest && other <= highest;
+		}
+	};
+
+	template <typename T> // Floating point
+	struct ValueNear {
+		T value;
+		T epsilon;
+
+		constexpr bool operator()(const T& other) const
+		{
+			return std::abs(other - value) <= epsilon;
+		}
+	};
+
+	namespace detail {
+		template <typename T, typename Predicate>
+		constexpr bool HAS_SIMD_VALUE_MATCH =
+#if defined(__SSE2__)
+			(std::same_as<Predicate, ValueEquals<T>> && (std::integral<T> || std::floating_point<T>))
+			|| (std::same_as<Predicate, ValueInRange<T>> && std::floating_point<T>)
+			|| (std::same_as<Predicate, ValueNear<T>> && std::floating_point<T>);
+#else
+			false;
+#endif
+
+#if defined(__SSE2__)
+		// Bit i is set if the i-th value of the 16-byte vector satisfies the predicate
+		template <typename T, typename Predicate>
+			requires HAS_SIMD_VALUE_MATCH<T, Predicate>
+		std::uint32_t simd_value_match(const std::byte* data, const Predicate& predicate)
+		{
+			const __m128i vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+			if constexpr (std::floating_point<T>) {
+				constexpr bool IS_FLOAT = sizeof(T) == sizeof(float);
+				auto broadcast = [](T v) {
+					if constexpr (IS_FLOAT)
+						return _mm_set1_ps(v);
+					else
+						return _mm_set1_pd(v);
+				};
+				auto movemask = [](auto mask) {
+					if constexpr (IS_FLOAT)
+						return static_cast<std::uint32_t>(_mm_movemask_ps(mask));
+					else
+						return static_cast<std::uint32_t>(_mm_movemask_pd(mask));
+				};
+
+				if constexpr (IS_FLOAT) {
+					const __m128 values = _mm_castsi128_ps(vector);
+					if constexpr (std::same_as<Predicate, ValueEquals<T>>)
+						return movemask(_mm_cmpeq_ps(values, broadcast(predicate.value)));
+					else if constexpr (std::same_as<Predicate, ValueInRange<T>>)
+						return movemask(_mm_and_ps(_mm_cmpge_ps(values, broadcast(predicate.lowest)), _mm_cmple_ps(values, broadcast(predicate.highest))));
+					else {
+						const __m128 difference = _mm_andnot_ps(_mm_set1_ps(-0.0F), _mm_sub_ps(values, broadcast(predicate.value)));
+						return movemask(_mm_cmple_ps(difference, broadcast(predicate.epsilon)));
+					}
+				} else {
+					const __m128d values = _mm_castsi128_pd(vector);
+					if constexpr (std::same_as<Predicate, ValueEquals<T>>)
+						return movemask(_mm_cmpeq_pd(values, broadcast(predicate.value)));
+					else if constexpr (std::same_as<Predicate, ValueInRange<T>>)
+						return movemask(_mm_and_pd(_mm_cmpge_pd(values, broadcast(predicate.lowest)), _mm_cmple_pd(values, broadcast(predicate.highest))));
+					else {
+						const __m128d difference = _mm_andnot_pd(_mm_set1_pd(-0.0), _mm_sub_pd(values, broadcast(predicate.value)));
+						return movemask(_mm_cmple_pd(difference, broadcast(predicate.epsilon)));
+					}
+				}
+			} else {
+				// Integer equality is bitwise equality
+				std::array<std::byte, 16> pattern{};
+				for (std::size_t i = 0; i < pattern.size(); i += sizeof(T))
+					std::memcpy(pattern.data() + i, &predicate.value, sizeof(T));
+				const __m128i needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.data()));
+
+				if constexpr (sizeof(T) == 1)
+					return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(vector, needle)));
+				else if constexpr (sizeof(T) == 2)
+					return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(vector, needle), _mm_setzero_si128())));
+				else if constexpr (sizeof(T) == 4)
+					return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(vector, needle))));
+				else {
+					const __m128i halves = _mm_cmpeq_epi32(vector, needle);
+					const __m128i both = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+					return static_cast<std::uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(both)));
+				}
+			}
+		}
+#endif
+
+		// Calls `callback(offset)` for every offset (a multiple of alignof(T)) at which a value satisfies the predicate
+		template <typename T, typename Predicate, typename F>
+		void scan_values(std::span<const std::byte> bytes, const Predicate& predicate, const F& callback)
+		{
+			std::size_t offset = 0;
+
+#if defined(__SSE2__)
+			if constexpr (HAS_SIMD_VALUE_MATCH<T, Predicate> && sizeof(T) == alignof(T)) {
+				static constexpr std::size_t VECTOR_WIDTH = 16;
+				for (; offset + VECTOR_WIDTH <= bytes.size(); offset += VECTOR_WIDTH) {
+					std::uint32_t hits = simd_value_match<T>(bytes.data() + offset, predicate);
+					while (hits != 0) {
+						callback(offset + std::countr_zero(hits) * sizeof(T));
+						hits &= hits - 1;
+					}
+				}
+			}
+#endif
+
+			for (; offset + sizeof(T) <= bytes.size(); offset += alignof(T)) {
+				T value;
+				std::memcpy(&value, bytes.data() + offset, sizeof(T));
+				if (predicate(value))
+					callback(offset);
+			}
+		}
+	}
+
+	/**
+	 * Result of a value scan, which remembers the value at every address to narrow the results down in later scans.
+	 * Narrowing re-reads all surviving addresses in batches, so successive scans only touch those.
+	 */
+	template <typename MemMgr, typename T>
+		requires std::is_trivially_copyable_v<T>
+	class ValueScan {
+		const MemMgr* memory_manager;
+		std::vector<std::uintptr_t> addresses; // Ascending
+		std::vector<T> values;
+
+	public:
+		ValueScan(const MemMgr& memory_manager, std::vector<std::uintptr_t>&& addresses, std::vector<T>&& values)
+			: memory_manager(&memory_manager)
+			, addresses(std::move(addresses))
+			, values(std::move(values))
+		{
+		}
+
+		// Keeps the addresses for which `keep(previous value, current value)` holds, unreadable addresses are dropped
+		template <typename F>
+			requires std::is_invocable_r_v<bool, F, const T&, const T&>
+		ValueScan& narrow(const F& keep)
+		{
+			std::vector<std::uintptr_t> new_addresses;
+			std::vector<T> new_values;
+
+			detail::batch_read(*memory_manager, addresses, sizeof(T), 0, [&](std::size_t index, const std::byte* bytes) {
+				if (bytes == nullptr)
+					return;
+
+				T value;
+				std::memcpy(&value, bytes, sizeof(T));
+				if (keep(values[index], value)) {
+					new_addresses.push_back(addresses[index]);
+					new_values.push_back(value);
+				}
+			});
+
+			addresses = std::move(new_addresses);
+			values = std::move(new_values);
+			return *this;
+		}
+
+		ValueScan& changed()
+		{
+			return narrow([](const T& previous, const T& current) {
+				return std::memcmp(&previous, &current, sizeof(T)) != 0;
+			});
+		}
+
+		ValueScan& unchanged()
+		{
+			return narrow([](const T& previous, const T& current) {
+				return std::memcmp(&previous, &current, sizeof(T)) == 0;
+			});
+		}
+
+		ValueScan& increased()
+			requires std::totally_ordered<T>
+		{
+			return narrow([](const T& previous, const T& current) {
+				return current > previous;
+			});
+		}
+
+		ValueScan& decreased()
+			requires std::totally_ordered<T>
+		{
+			return narrow([](const T& previous, const T& current) {
+				return current < previous;
+			});
+		}
+
+		template <typename Predicate>
+			requires std::predicate<Predicate, const T&>
+		ValueScan& matching(const Predicate& predicate)
+		{
+			return narrow([&predicate](const T&, const T& current) {
+				return predicate(current);
+			});
+		}
+
+		ValueScan& equals(const T& value)
+			requires std::equality_comparable<T>
+		{
+			return matching(ValueEquals<T>{ value });
+		}
+
+		[[nodiscard]] Session<MemMgr> session() const
+		{
+			return pointer_list(*memory_manager, addresses);
+		}
+
+		[[nodiscard]] const std::vector<std::uintptr_t>& get_addresses() const
+		{
+			return addresses;
+		}
+
+		[[nodiscard]] const std::vector<T>& get_values() const
+		{
+			return values;
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return addresses.size();
+		}
+	};
+
+	// Scans for values of type T (at T's alignment) which satisfy the predicate
+	template <typename T, typename MemMgr, typename Predicate>
+		requires MemoryManager::Viewable<typename MemMgr::RegionT> && std::is_trivially_copyable_v<T> && std::predicate<Predicate, const T&>
+	[[nodiscard]] inline ValueScan<MemMgr, T> values(
+		const MemMgr& memory_manager,
+		const Predicate& predicate,
+		const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().with_flags("rw-"))
+	{
+		std::vector<std::uintptr_t> addresses;
+		std::vector<T> found_values;
+
+		for (const auto& region : memory_manager.get_layout()) {
+			if (!search_constraints.allows_region(region))
+				continue;
+
+			detail::RegionBytes<typename MemMgr::RegionT> region_bytes{ region };
+			std::span<const std::byte> bytes = region_bytes.get();
+
+			auto begin = bytes.begin();
+			auto end = bytes.end();
+
+			search_constraints.clamp_to_address_range(region, bytes.begin(), begin, end);
+
+			if (begin >= end)
+				continue;
+
+			// Keep the alignment when the start was clamped
+			std::uintptr_t address = region.get_address() + std::distance(bytes.begin(), begin);
+			const std::size_t misalignment = (alignof(T) - address % alignof(T)) % alignof(T);
+			if (static_cast<std::size_t>(std::distance(begin, end)) <= misalignment)
+				continue;
+			std::advance(begin, misalignment);
+			address += misalignment;
+
+			std::span<const std::byte> haystack{ begin, end };
+			detail::scan_values<T>(haystack, predicate, [&](std::size_t offset) {
+				addresses.push_back(address + offset);
+				T value;
+				std::memcpy(&value, haystack.data() + offset, sizeof(T));
+				found_values.push_back(value);
+			});
+		}
+
+		return { memory_manager, std::move(addresses), std::move(found_values) };
+	}
+
+	template <typename T, typename MemMgr>
+		requires MemoryManager::Viewable<typename MemMgr::RegionT> && std::is_trivially_copyable_v<T> && std::equality_comparable<T>
+	[[nodiscard]] inline ValueScan<MemMgr, T> values(
+		const MemMgr& memory_manager,
+		const std::type_identity_t<T>& value,
+		const SearchConstraints<typename MemMgr::RegionT>& search_constraints = everything<MemMgr>().with_flags("rw-"))
+	{
+		return values<T>(memory_manager, ValueEquals<T>{ value }, search_constraints);
+	}
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef BCRL_DETAIL_BATCHREAD_HPP
+#define BCRL_DETAIL_BATCHREAD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace BCRL::detail {
+	/**
+	 * Reads `length` bytes at every address of an ascending list, nearby addresses inside the same region share a single read.
+	 * The callback receives the position of the address in the list and a pointer to its bytes, which are followed by
+	 * `padding` zero bytes. If the bytes aren't contained in a single readable region, it receives nullptr instead.
+	 * The pointers stay valid until `after_batch` is called, which happens before the buffer is reused.
+	 */
+	template <typename MemMgr, typename F, typename G>
+	void batch_read(const MemMgr& memory_manager, std::span<const std::uintptr_t> addresses, std::size_t length, std::size_t padding, const F& callback, const G& after_batch)
+	{
+		static constexpr std::size_t MAX_BATCH_SIZE = 64 * 1024;
+		static constexpr std::size_t MAX_GAP = 4 * 1024; // Reading a small gap is cheaper than issuing another read
+
+		std::vector<std::byte> buffer;
+		const typename MemMgr::RegionT* region = nullptr;
+
+		std::size_t i = 0;
+		while (i < addresses.size()) {
+			const std::uintptr_t address = addresses[i];
+
+			if (!region || address < region->get_address() || address >= region->get_address() + region->get_length())
+				region = memory_manager.get_layout().find_region(address);
+
+			bool readable = region != nullptr;
+			if constexpr (MemMgr::REQUIRES_PERMISSIONS_FOR_READING)
+				readable = readable && region->get_flags().is_readable();
+
+			if (!readable || address + length > region->get_address() + region->get_length()) {
+				callback(i, nullptr);
+				i++;
+				continue;
+			}
+
+			const std::uintptr_t region_end = region->get_address() + region->get_length();
+
+			std::size_t j = i + 1;
+			std::uintptr_t batch_end = address + length;
+			for (; j < addresses.size(); j++) {
+				const std::uintptr_t next = addresses[j];
+				if (next + length > region_end || next > batch_end + MAX_GAP || next + length - address > MAX_BATCH_SIZE)
+					break;
+				batch_end = std::max(batch_end, next + length);
+			}
+
+			const std::size_t batch_size = batch_end - address;
+			buffer.resize(batch_size + padding);
+			memory_manager.read(address, buffer.data(), batch_size);
+			std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(batch_size), buffer.end(), std::byte{ 0 });
+
+			for (; i < j; i++)
+				callback(i, buffer.data() + (addresses[i] - address));
+			after_batch();
+		}
+	}
+
+	template <typename MemMgr, typename F>
+	void batch_read(const MemMgr& memory_manager, std::span<const std::uintptr_t> addresses, std::size_t length, std::size_t padding, const F& callback)
+	{
+		batch_read(memory_manager, addresses, length, padding, callback, [] {});
+	}
+}
+
+#endif
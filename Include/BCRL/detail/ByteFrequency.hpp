@@ -0,0 +1,23 @@
+#ifndef BCRL_DETAIL_BYTEFREQUENCY_HPP
+#define BCRL_DETAIL_BYTEFREQUENCY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace BCRL::detail {
+	// Rough ranking of how often a byte occurs in x86 code and data, higher is more common
+	constexpr std::size_t byte_commonness(std::byte b)
+	{
+		constexpr std::array<std::uint8_t, 24> COMMON_BYTES{
+			0x00, 0xFF, 0x48, 0x8B, 0x89, 0x0F, 0xE8, 0x24, 0x44, 0x4C, 0x85, 0xC0,
+			0x01, 0x74, 0x75, 0x83, 0x8D, 0x45, 0x41, 0xCC, 0x90, 0x49, 0xC3, 0x20
+		};
+		for (std::size_t i = 0; i < COMMON_BYTES.size(); i++)
+			if (COMMON_BYTES[i] == static_cast<std::uint8_t>(b))
+				return COMMON_BYTES.size() - i;
+		return 0;
+	}
+}
+
+#endif
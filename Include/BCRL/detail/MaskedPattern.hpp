@@ -0,0 +1,181 @@
+#ifndef BCRL_DETAIL_MASKEDPATTERN_HPP
+#define BCRL_DETAIL_MASKEDPATTERN_HPP
+
+#include "ByteFrequency.hpp"
+#include "PatternText.hpp"
+
+#include "SignatureScanner/PatternSignature.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace BCRL::detail {
+	/**
+	 * Flat byte/mask representation of a PatternSignature, wildcards have a mask of zero.
+	 * Both arrays are padded with wildcards to a multiple of the vector width.
+	 */
+	class MaskedPattern {
+		std::vector<std::byte> bytes;
+		std::vector<std::byte> mask;
+		std::size_t length;
+		std::size_t anchor; // Rarest non-wildcard byte, `length` if there is none
+		std::vector<std::size_t> checks; // Non-wildcard bytes, rarest first
+
+	public:
+		static constexpr std::size_t VECTOR_WIDTH = 16;
+
+		explicit MaskedPattern(const SignatureScanner::PatternSignature& signature)
+			: length(signature.get_elements().size())
+			, anchor(length)
+		{
+			const std::size_t padded_length = (length + VECTOR_WIDTH - 1) / VECTOR_WIDTH * VECTOR_WIDTH;
+			bytes.resize(padded_length);
+			mask.resize(padded_length);
+
+			std::size_t i = 0;
+			for (const PatternElement& element : signature.get_elements()) {
+				if (element.has_value()) {
+					bytes[i] = element.value();
+					mask[i] = std::byte{ 0xFF };
+					if (anchor == length || byte_commonness(bytes[i]) < byte_commonness(bytes[anchor]))
+						anchor = i;
+				}
+				i++;
+			}
+
+			for (std::size_t index = 0; index < length; index++)
+				if (!is_wildcard(index))
+					checks.push_back(index);
+			std::ranges::stable_sort(checks, {}, [this](std::size_t index) { return byte_commonness(bytes[index]); });
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return length;
+		}
+
+		[[nodiscard]] std::byte byte_at(std::size_t index) const
+		{
+			return bytes[index];
+		}
+
+		[[nodiscard]] bool is_wildcard(std::size_t index) const
+		{
+			return mask[index] == std::byte{ 0 };
+		}
+
+		/**
+		 * Verifies up to VECTOR_WIDTH candidates at once, each of which has to point to at least size() bytes.
+		 * Every step compares the same pattern byte of all candidates in a single vector, starting with the rarest byte,
+		 * so most mismatching candidates are rejected together after the first step.
+		 * Bit i of the result is set if candidate i matches.
+		 */
+		[[nodiscard]] std::uint32_t matches_many(std::span<const std::byte* const> candidates) const
+		{
+			const std::size_t count = std::min(candidates.size(), VECTOR_WIDTH);
+			std::uint32_t alive = (1U << count) - 1;
+
+			for (std::size_t i = 0; i < checks.size() && alive != 0; i++) {
+				const std::size_t index = checks[i];
+#if defined(__SSE2__)
+				alignas(VECTOR_WIDTH) std::array<std::byte, VECTOR_WIDTH> lanes{};
+				for (std::size_t j = 0; j < count; j++)
+					lanes[j] = candidates[j][index];
+				const __m128i column = _mm_load_si128(reinterpret_cast<const __m128i*>(lanes.data()));
+				const __m128i equal = _mm_cmpeq_epi8(column, _mm_set1_epi8(static_cast<char>(bytes[index])));
+				alive &= static_cast<std::uint32_t>(_mm_movemask_epi8(equal));
+#else
+				for (std::size_t j = 0; j < count; j++)
+					if (candidates[j][index] != bytes[index])
+						alive &= ~(1U << j);
+#endif
+			}
+
+			return alive;
+		}
+
+		// `candidate` has to point to at least size() bytes
+		[[nodiscard]] bool matches(const std::byte* candidate) const
+		{
+			std::size_t i = 0;
+#if defined(__SSE2__)
+			for (; i + VECTOR_WIDTH <= length; i += VECTOR_WIDTH)
+				if (!matches_block(candidate, i))
+					return false;
+#endif
+			for (; i < length; i++)
+				if ((candidate[i] & mask[i]) != bytes[i])
+					return false;
+			return true;
+		}
+
+		/**
+		 * Offset of the last match which fits entirely into `haystack` and doesn't start before `lowest_start`, or haystack.size().
+		 * Blocks are processed from high to low addresses, looking for the anchor byte with SIMD compares first.
+		 */
+		[[nodiscard]] std::size_t prev(std::span<const std::byte> haystack, std::size_t lowest_start = 0) const
+		{
+			if (haystack.size() < length || lowest_start > haystack.size() - length)
+				return haystack.size();
+
+			const std::size_t highest_start = haystack.size() - length;
+
+			if (anchor == length)
+				return highest_start;
+
+			const std::byte* data = haystack.data();
+			const std::byte needle = bytes[anchor];
+
+			// Candidate positions of the anchor byte are [first, end)
+			const std::size_t first = lowest_start + anchor;
+			std::size_t end = highest_start + anchor + 1;
+
+#if defined(__SSE2__)
+			const __m128i broadcast = _mm_set1_epi8(static_cast<char>(needle));
+			while (end - first >= VECTOR_WIDTH) {
+				const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end - VECTOR_WIDTH));
+				auto hits = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, broadcast)));
+				while (hits != 0) {
+					const std::size_t highest = std::bit_width(hits) - 1;
+					const std::size_t start = end - VECTOR_WIDTH + highest - anchor;
+					if (matches(data + start))
+						return start;
+					hits &= ~(1U << highest);
+				}
+				end -= VECTOR_WIDTH;
+			}
+#endif
+
+			while (end > first) {
+				end--;
+				if (data[end] == needle && matches(data + end - anchor))
+					return end - anchor;
+			}
+
+			return haystack.size();
+		}
+
+	private:
+#if defined(__SSE2__)
+		[[nodiscard]] bool matches_block(const std::byte* candidate, std::size_t offset) const
+		{
+			const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidate + offset));
+			const __m128i pattern = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes.data() + offset));
+			const __m128i pattern_mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.data() + offset));
+			const __m128i equal = _mm_cmpeq_epi8(_mm_and_si128(data, pattern_mask), pattern);
+			return _mm_movemask_epi8(equal) == 0xFFFF;
+		}
+#endif
+	};
+}
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef BCRL_DETAIL_MODULES_HPP
+#define BCRL_DETAIL_MODULES_HPP
+
+#include "../SafePointer.hpp"
+
+#include "MemoryManager/MemoryManager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BCRL::detail {
+	// All regions sharing a name, e.g. the segments of a shared object
+	struct Module {
+		std::string name;
+		std::uintptr_t base;
+		std::uintptr_t end;
+		std::uint64_t identity; // Equal for the same binary, regardless of where it was loaded
+	};
+
+	inline std::uint64_t fnv1a(std::span<const std::byte> bytes, std::uint64_t hash = 0xCBF29CE484222325)
+	{
+		for (std::byte b : bytes)
+			hash = (hash ^ static_cast<std::uint64_t>(b)) * 0x100000001B3;
+		return hash;
+	}
+
+	template <typename T>
+	T load(std::span<const std::byte> bytes, std::size_t offset)
+	{
+		T value{};
+		if (offset + sizeof(T) <= bytes.size())
+			std::memcpy(&value, bytes.data() + offset, sizeof(T));
+		return value;
+	}
+
+	// The GNU build-id note of a loaded 64-bit ELF file, if there is one
+	template <typename MemMgr>
+	std::optional<std::vector<std::byte>> read_build_id(const MemMgr& memory_manager, std::uintptr_t base)
+	{
+		static constexpr std::size_t HEADER_SIZE = 64;
+		static constexpr std::size_t PROGRAM_HEADER_SIZE = 56;
+		static constexpr std::uint32_t PT_LOAD = 1;
+		static constexpr std::uint32_t PT_NOTE = 4;
+		static constexpr std::uint32_t NT_GNU_BUILD_ID = 3;
+		static constexpr std::size_t MAX_NOTES_SIZE = 4096;
+
+		std::array<std::byte, HEADER_SIZE> header{};
+		if (!SafePointer{ memory_manager, base }.read(header.data(), header.size()))
+			return std::nullopt;
+
+		static constexpr std::array<unsigned char, 5> ELF64_MAGIC{ 0x7F, 'E', 'L', 'F', 2 };
+		if (std::memcmp(header.data(), ELF64_MAGIC.data(), ELF64_MAGIC.size()) != 0)
+			return std::nullopt;
+
+		const auto program_headers_offset = load<std::uint64_t>(header, 0x20);
+		const auto program_header_size = load<std::uint16_t>(header, 0x36);
+		const auto program_header_count = load<std::uint16_t>(header, 0x38);
+		if (program_header_size < PROGRAM_HEADER_SIZE)
+			return std::nullopt;
+
+		std::vector<std::byte> program_headers(static_cast<std::size_t>(program_header_size) * program_header_count);
+		if (!SafePointer{ memory_manager, base + program_headers_offset }.read(program_headers.data(), program_headers.size()))
+			return std::nullopt;
+
+		// Virtual addresses are relative to the first loadable segment, which is mapped at the base
+		std::optional<std::uintptr_t> load_bias;
+		for (std::size_t i = 0; i < program_header_count && !load_bias; i++)
+			if (load<std::uint32_t>(program_headers, i * program_header_size) == PT_LOAD)
+				load_bias = base - (load<std::uint64_t>(program_headers, i * program_header_size + 0x10) & ~std::uint64_t{ 0xFFF });
+		if (!load_bias)
+			return std::nullopt;
+
+		for (std::size_t i = 0; i < program_header_count; i++) {
+			const std::size_t program_header = i * program_header_size;
+			if (load<std::uint32_t>(program_headers, program_header) != PT_NOTE)
+				continue;
+
+			std::vector<std::byte> notes(std::min<std::size_t>(load<std::uint64_t>(program_headers, program_header + 0x28), MAX_NOTES_SIZE));
+			if (!SafePointer{ memory_manager, *load_bias + load<std::uint64_t>(program_headers, program_header + 0x10) }.read(notes.data(), notes.size()))
+				continue;
+
+			auto align = [](std::size_t n) { return (n + 3) & ~std::size_t{ 3 }; };
+			for (std::size_t offset = 0; offset + 12 <= notes.size();) {
+				const auto name_size = load<std::uint32_t>(notes, offset);
+				const auto description_size = load<std::uint32_t>(notes, offset + 4);
+				const auto type = load<std::uint32_t>(notes, offset + 8);
+				const std::size_t name = offset + 12;
+				const std::size_t description = name + align(name_size);
+				if (description + description_size > notes.size())
+					break;
+
+				if (type == NT_GNU_BUILD_ID && name_size == 4 && std::memcmp(notes.data() + name, "GNU", 4) == 0)
+					return std::vector<std::byte>{ notes.begin() + static_cast<std::ptrdiff_t>(description), notes.begin() + static_cast<std::ptrdiff_t>(description + description_size) };
+
+				offset = description + align(description_size);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	// Identity of the module at `base`: Its build-id, or if it has none, a hash of its first page and its size
+	template <typename MemMgr>
+	std::uint64_t module_identity(const MemMgr& memory_manager, std::uintptr_t base, std::size_t size)
+	{
+		if (auto build_id = read_build_id(memory_manager, base))
+			return fnv1a(*build_id);
+
+		std::array<std::byte, 4096> page{};
+		std::size_t length = page.size();
+		const SafePointer safe_pointer{ memory_manager, base };
+		while (length > 0 && !safe_pointer.is_valid(length))
+			length /= 2;
+		if (length > 0)
+			memory_manager.read(base, page.data(), length);
+
+		return fnv1a(std::as_bytes(std::span{ &size, 1 }), fnv1a(std::span{ page }.first(length)));
+	}
+
+	// Named, file-backed modules, ascending by base
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::LengthAware<typename MemMgr::RegionT> && MemoryManager::NameAware<typename MemMgr::RegionT>
+	std::vector<Module> list_modules(const MemMgr& memory_manager)
+	{
+		std::vector<Module> modules;
+
+		for (const auto& region : memory_manager.get_layout()) {
+			const std::string name{ region.get_name() };
+			if (name.empty() || name.starts_with('[')) // Anonymous memory or pseudo-regions like [heap]
+				continue;
+
+			const std::uintptr_t begin = region.get_address();
+			const std::uintptr_t end = begin + region.get_length();
+
+			auto it = std::ranges::find(modules, name, &Module::name);
+			if (it == modules.end()) {
+				modules.push_back({ name, begin, end, 0 });
+			} else {
+				it->base = std::min(it->base, begin);
+				it->end = std::max(it->end, end);
+			}
+		}
+
+		for (Module& module : modules)
+			module.identity = module_identity(memory_manager, module.base, module.end - module.base);
+
+		std::ranges::sort(modules, {}, &Module::base);
+		return modules;
+	}
+
+	// Lowest address of the regions with that name
+	template <typename MemMgr>
+		requires MemoryManager::LayoutAware<MemMgr> && MemoryManager::AddressAware<typename MemMgr::RegionT> && MemoryManager::NameAware<typename MemMgr::RegionT>
+	std::optional<std::uintptr_t> module_base(const MemMgr& memory_manager, std::string_view name)
+	{
+		std::optional<std::uintptr_t> base;
+		for (const auto& region : memory_manager.get_layout())
+			if (region.get_name() == name && (!base || region.get_address() < *base))
+				base = region.get_address();
+		return base;
+	}
+
+	// The module which contains the address
+	inline const Module* find_module(const std::vector<Module>& modules, std::uintptr_t address)
+	{
+		auto it = std::ranges::upper_bound(modules, address, {}, &Module::base);
+		if (it == modules.begin() || address >= std::prev(it)->end)
+			return nullptr;
+		return &*std::prev(it);
+	}
+}
+
+#endif
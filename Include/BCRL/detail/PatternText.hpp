@@ -0,0 +1,86 @@
+#ifndef BCRL_DETAIL_PATTERNTEXT_HPP
+#define BCRL_DETAIL_PATTERNTEXT_HPP
+
+#include "SignatureScanner/PatternSignature.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace BCRL::detail {
+	using PatternElement = typename std::remove_cvref_t<decltype(std::declval<const SignatureScanner::PatternSignature&>().get_elements())>::value_type;
+
+	// Runtime counterpart to `PatternSignature::for_array_of_bytes`, e.g. "48 8d 05 ? ? ? ?"
+	inline std::optional<SignatureScanner::PatternSignature> parse_array_of_bytes(std::string_view text)
+	{
+		std::vector<PatternElement> elements;
+
+		std::size_t i = 0;
+		while (i < text.size()) {
+			if (text[i] == ' ') {
+				i++;
+				continue;
+			}
+
+			std::size_t end = text.find(' ', i);
+			if (end == std::string_view::npos)
+				end = text.size();
+			std::string_view token = text.substr(i, end - i);
+			i = end;
+
+			if (token == "?" || token == "??") {
+				elements.emplace_back();
+				continue;
+			}
+
+			unsigned int value = 0;
+			auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value, 16);
+			if (ec != std::errc{} || ptr != token.data() + token.size() || token.size() != 2)
+				return std::nullopt;
+			elements.emplace_back(static_cast<std::byte>(value));
+		}
+
+		if (elements.empty())
+			return std::nullopt;
+
+		return SignatureScanner::PatternSignature{ std::move(elements) };
+	}
+
+	// Runtime counterpart to `PatternSignature::for_literal_string`, including the null terminator
+	inline SignatureScanner::PatternSignature literal_string(std::string_view text)
+	{
+		std::vector<PatternElement> elements;
+		elements.reserve(text.size() + 1);
+		for (char c : text)
+			elements.emplace_back(static_cast<std::byte>(c));
+		elements.emplace_back(std::byte{ 0 });
+		return SignatureScanner::PatternSignature{ std::move(elements) };
+	}
+
+	// Inverse of parse_array_of_bytes
+	inline std::string pattern_to_string(const SignatureScanner::PatternSignature& signature)
+	{
+		static constexpr std::string_view HEX = "0123456789abcdef";
+
+		std::string text;
+		for (const PatternElement& element : signature.get_elements()) {
+			if (!text.empty())
+				text.push_back(' ');
+			if (!element.has_value()) {
+				text.push_back('?');
+				continue;
+			}
+			const auto b = static_cast<unsigned char>(element.value());
+			text.push_back(HEX[b >> 4]);
+			text.push_back(HEX[b & 0xF]);
+		}
+		return text;
+	}
+}
+
+#endif
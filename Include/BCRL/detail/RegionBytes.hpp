@@ -0,0 +1,46 @@
+#ifndef BCRL_DETAIL_REGIONBYTES_HPP
+#define BCRL_DETAIL_REGIONBYTES_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace BCRL::detail {
+	// Contiguous access to the bytes of a region view, copies them only if the view can't provide that on its own
+	template <typename Region>
+	class RegionBytes {
+		using View = decltype(std::declval<const Region&>().view());
+		using Iterator = decltype(std::declval<const View&>().cbegin());
+
+		View view;
+		std::vector<std::byte> copy;
+		std::span<const std::byte> bytes;
+
+	public:
+		explicit RegionBytes(const Region& region)
+			: view(region.view())
+		{
+			if constexpr (std::contiguous_iterator<Iterator> && sizeof(std::iter_value_t<Iterator>) == 1) {
+				bytes = { reinterpret_cast<const std::byte*>(std::to_address(view.cbegin())), static_cast<std::size_t>(std::distance(view.cbegin(), view.cend())) };
+			} else {
+				for (auto it = view.cbegin(); it != view.cend(); ++it)
+					copy.push_back(static_cast<std::byte>(*it));
+				bytes = copy;
+			}
+		}
+
+		RegionBytes(const RegionBytes&) = delete;
+		RegionBytes& operator=(const RegionBytes&) = delete;
+
+		[[nodiscard]] std::span<const std::byte> get() const
+		{
+			return bytes;
+		}
+	};
+}
+
+#endif
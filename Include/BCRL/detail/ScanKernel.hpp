@@ -0,0 +1,28 @@
+#ifndef BCRL_DETAIL_SCANKERNEL_HPP
+#define BCRL_DETAIL_SCANKERNEL_HPP
+
+namespace BCRL::detail {
+	// Selects the template implementation of a scan kernel, which is what compiled kernels run as well
+	struct KernelImplementation {};
+
+	/**
+	 * The hot loops of the scans (signature scans and xref decoding) for a memory manager.
+	 * By default, they are instantiated from the templates wherever they are used.
+	 * BCRLScan specializes this for the memory managers it contains compiled kernels for (see ScanLibrary.hpp), the templates call those instead.
+	 *
+	 * Whether the specialization is visible changes the inline definitions of the templates,
+	 * so either every translation unit of a program defines BCRL_SCAN_LIBRARY or none does.
+	 * With BCRL_BUILD_SCAN_LIBRARY, the BCRL target defines it and links BCRLScan for everything that uses it.
+	 */
+	template <typename MemMgr>
+	struct ScanKernels {
+		static constexpr bool IS_COMPILED = false;
+	};
+}
+
+// The specializations have to be visible before anything gets instantiated
+#ifdef BCRL_SCAN_LIBRARY
+#include "../ScanLibrary.hpp"
+#endif
+
+#endif
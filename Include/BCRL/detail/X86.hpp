@@ -0,0 +1,130 @@
+#ifndef BCRL_DETAIL_X86_HPP
+#define BCRL_DETAIL_X86_HPP
+
+#include "LengthDisassembler/LengthDisassembler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+namespace BCRL::detail::x86 {
+	// Number of legacy and REX prefixes in front of the opcode
+	constexpr std::size_t prefix_length(std::span<const std::byte> instruction, bool long_mode = sizeof(void*) == 8)
+	{
+		std::size_t i = 0;
+		while (i < instruction.size()) {
+			switch (static_cast<std::uint8_t>(instruction[i])) {
+			case 0x26:
+			case 0x2E:
+			case 0x36:
+			case 0x3E:
+			case 0x64:
+			case 0x65:
+			case 0x66:
+			case 0x67:
+			case 0xF0:
+			case 0xF2:
+			case 0xF3:
+				i++;
+				continue;
+			default:
+				break;
+			}
+			break;
+		}
+		if (long_mode && i < instruction.size() && (static_cast<std::uint8_t>(instruction[i]) & 0xF0) == 0x40)
+			i++;
+		return i;
+	}
+
+	inline std::int32_t read_rel32(std::span<const std::byte> bytes)
+	{
+		std::int32_t value = 0;
+		std::memcpy(&value, bytes.data(), sizeof(value));
+		return value;
+	}
+
+	struct Operand {
+		std::size_t offset;
+		std::size_t size;
+	};
+
+	/**
+	 * The operand of an instruction which changes when code or data moves:
+	 * The rel32 of call, jmp and jcc or the disp32 of RIP-relative addressing (an absolute address outside of long mode).
+	 * `instruction` has to be exactly one instruction, as decoded by the length disassembler.
+	 *
+	 * Whether the byte behind the opcode is a ModR/M byte is left to the length disassembler:
+	 * If it encodes a bare disp32 (mod = 00, r/m = 101), switching it to register addressing (mod = 11) shortens the instruction by those four bytes,
+	 * whereas an immediate or an opcode without memory operand keeps its length.
+	 */
+	inline std::optional<Operand> relocatable_operand(
+		std::span<const std::byte> instruction,
+		LengthDisassembler::MachineMode mode = (sizeof(void*) == 8)
+			? LengthDisassembler::MachineMode::LONG_MODE
+			: LengthDisassembler::MachineMode::LONG_COMPATIBILITY_MODE)
+	{
+		static constexpr std::size_t DISPLACEMENT_SIZE = 4;
+
+		const bool long_mode = mode == LengthDisassembler::MachineMode::LONG_MODE;
+		auto at = [&instruction](std::size_t i) {
+			return static_cast<std::uint8_t>(instruction[i]);
+		};
+		auto operand = [&instruction](std::size_t offset) -> std::optional<Operand> {
+			if (offset + DISPLACEMENT_SIZE > instruction.size())
+				return std::nullopt;
+			return Operand{ offset, DISPLACEMENT_SIZE };
+		};
+
+		std::size_t i = prefix_length(instruction, long_mode);
+		if (i >= instruction.size())
+			return std::nullopt;
+
+		const std::uint8_t opcode = at(i);
+
+		if (opcode == 0xE8 || opcode == 0xE9)
+			return operand(i + 1);
+
+		// Skip to the byte behind the opcode
+		if (long_mode && (opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62)) {
+			i += (opcode == 0xC5 ? 2 : opcode == 0xC4 ? 3 : 4) + 1; // VEX and EVEX prefix, followed by the opcode
+		} else if (opcode == 0x0F) {
+			if (i + 1 >= instruction.size())
+				return std::nullopt;
+			const std::uint8_t second = at(i + 1);
+			if (second >= 0x80 && second <= 0x8F)
+				return operand(i + 2); // jcc rel32
+			i += second == 0x38 || second == 0x3A ? 3 : 2;
+		} else {
+			i += 1;
+		}
+
+		if (i >= instruction.size() || (at(i) & 0xC7) != 0x05 || instruction.size() > LengthDisassembler::MAX_INSTRUCTION_LENGTH)
+			return std::nullopt;
+
+		std::array<std::byte, LengthDisassembler::MAX_INSTRUCTION_LENGTH> register_form{};
+		std::ranges::copy(instruction, register_form.begin());
+		register_form[i] |= std::byte{ 0xC0 };
+
+		auto decoded = LengthDisassembler::disassemble(register_form.data(), mode, instruction.size());
+		if (!decoded.has_value() || decoded.value().length + DISPLACEMENT_SIZE != instruction.size())
+			return std::nullopt;
+		return operand(i + 1);
+	}
+
+	// endbr64/endbr32, emitted at the start of every indirectly callable function with CET enabled
+	constexpr bool is_endbr(std::span<const std::byte> instruction)
+	{
+		return instruction.size() >= 4
+			&& instruction[0] == std::byte{ 0xF3 }
+			&& instruction[1] == std::byte{ 0x0F }
+			&& instruction[2] == std::byte{ 0x1E }
+			&& (instruction[3] == std::byte{ 0xFA } || instruction[3] == std::byte{ 0xFB });
+	}
+}
+
+#endif
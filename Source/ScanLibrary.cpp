@@ -0,0 +1,60 @@
+#include "BCRL/ScanLibrary.hpp"
+
+#include "BCRL/SafePointer.hpp"
+#include "BCRL/Session.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The signature scans and the xref search are built in one version per instruction set extension,
+ * the best one for the CPU is picked when the program is loaded.
+ * flatten inlines the template implementations, so that all of their code is compiled for the extension.
+ */
+#if defined(__has_attribute) && (defined(__x86_64__) || defined(__i386__))
+#if __has_attribute(target_clones)
+#define BCRL_SCAN_KERNEL __attribute__((target_clones("avx2", "default"), flatten))
+#endif
+#endif
+#ifndef BCRL_SCAN_KERNEL
+#define BCRL_SCAN_KERNEL
+#endif
+
+namespace BCRL::detail {
+	using LocalScanKernels = ScanKernels<LocalLinuxMemoryManager>;
+
+	BCRL_SCAN_KERNEL LocalScanKernels::SafePointerT& LocalScanKernels::prev_signature_occurrence(
+		SafePointerT& safe_pointer,
+		const SignatureScanner::PatternSignature& signature,
+		std::size_t max_distance,
+		const SearchConstraintsT& search_constraints)
+	{
+		return safe_pointer.prev_signature_occurrence(KernelImplementation{}, signature, max_distance, search_constraints);
+	}
+
+	BCRL_SCAN_KERNEL LocalScanKernels::SafePointerT& LocalScanKernels::next_signature_occurrence(
+		SafePointerT& safe_pointer,
+		const SignatureScanner::PatternSignature& signature,
+		const SearchConstraintsT& search_constraints)
+	{
+		return safe_pointer.next_signature_occurrence(KernelImplementation{}, signature, search_constraints);
+	}
+
+	BCRL_SCAN_KERNEL std::vector<LocalScanKernels::SafePointerT> LocalScanKernels::find_xrefs(
+		const SafePointerT& safe_pointer,
+		SignatureScanner::XRefTypes types,
+		std::uint8_t instruction_length,
+		const SearchConstraintsT& search_constraints)
+	{
+		return safe_pointer.find_xrefs(KernelImplementation{}, types, instruction_length, search_constraints);
+	}
+
+	BCRL_SCAN_KERNEL Session<LocalLinuxMemoryManager> LocalScanKernels::signature(
+		const LocalLinuxMemoryManager& memory_manager,
+		const SignatureScanner::PatternSignature& signature,
+		const SearchConstraintsT& search_constraints)
+	{
+		return signature_scan(memory_manager, signature, search_constraints);
+	}
+}